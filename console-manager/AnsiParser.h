@@ -0,0 +1,208 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "LogStore.h"
+
+//  escape- ANSI   .
+//    ,    (SGR: 30-37, 90-97,
+// 38;5;n, 38;2;r;g;b)   ColorSpan.    
+//    ,    ,      .
+//     
+class AnsiParser {
+public:
+    static const uint32_t DefaultColor = 0;     //    -    
+
+private:
+    static const size_t MaxParameters = 16;
+
+    uint32_t color;
+    int paletteIndex;       //      (-1 -   )
+    bool bold;              //      
+
+public:
+    AnsiParser() : color(DefaultColor), paletteIndex(-1), bold(false) {}
+
+    //  .         ,  false
+    // (    );     
+    //  plain,    -  spans
+    bool parse(const char* text, size_t length, std::string& plain, std::vector<ColorSpan>& spans) {
+        const char* escape = static_cast<const char*>(memchr(text, 0x1b, length));
+        if (!escape && color == DefaultColor) {
+            return false;
+        }
+
+        plain.clear();
+        spans.clear();
+        const char* end = text + length;
+        const char* p = text;
+        while (p < end) {
+            const char* next = static_cast<const char*>(memchr(p, 0x1b, static_cast<size_t>(end - p)));
+            appendRun(p, next ? next : end, plain, spans);
+            if (!next) {
+                break;
+            }
+            p = skipEscape(next + 1, end);
+        }
+        return true;
+    }
+
+    //     IM_COL32 (R   , )
+    static uint32_t rgba(int r, int g, int b) {
+        return 0xFF000000u | (static_cast<uint32_t>(b & 0xFF) << 16) |
+            (static_cast<uint32_t>(g & 0xFF) << 8) | static_cast<uint32_t>(r & 0xFF);
+    }
+
+private:
+    void appendRun(const char* begin, const char* end, std::string& plain, std::vector<ColorSpan>& spans) {
+        if (begin == end) {
+            return;
+        }
+        uint32_t offset = static_cast<uint32_t>(plain.size());
+        uint32_t length = static_cast<uint32_t>(end - begin);
+        plain.append(begin, end);
+        if (color == DefaultColor) {
+            return;
+        }
+        if (!spans.empty() && spans.back().color == color && spans.back().offset + spans.back().length == offset) {
+            spans.back().length += length;
+            return;
+        }
+        ColorSpan span = { offset, length, color };
+        spans.push_back(span);
+    }
+
+    //    ESC,  SGR.    
+    const char* skipEscape(const char* p, const char* end) {
+        if (p == end) {
+            return end;
+        }
+        if (*p == '[') {
+            // CSI: ,     
+            const char* parameters = ++p;
+            while (p < end && *p >= 0x30 && *p <= 0x3F) {
+                ++p;
+            }
+            const char* parametersEnd = p;
+            while (p < end && *p >= 0x20 && *p <= 0x2F) {
+                ++p;
+            }
+            if (p == end) {
+                return end;
+            }
+            if (*p == 'm') {
+                applySgr(parameters, parametersEnd);
+            }
+            return p + 1;
+        }
+        if (*p == ']') {
+            // OSC (,  )  BEL  ESC '\'
+            for (++p; p < end; ++p) {
+                if (*p == '\a') {
+                    return p + 1;
+                }
+                if (*p == 0x1b && p + 1 < end && p[1] == '\\') {
+                    return p + 2;
+                }
+            }
+            return end;
+        }
+        if ((*p == '(' || *p == ')') && p + 1 < end) {
+            return p + 2;   //  : ESC ( B
+        }
+        return p + 1;
+    }
+
+    void applySgr(const char* begin, const char* end) {
+        int values[MaxParameters];
+        size_t count = 0;
+        int value = 0;
+        for (const char* p = begin; ; ++p) {
+            if (p == end || *p == ';' || *p == ':') {
+                if (count < MaxParameters) {
+                    values[count++] = value;
+                }
+                value = 0;
+                if (p == end) {
+                    break;
+                }
+            }
+            else if (*p >= '0' && *p <= '9' && value < 10000) {
+                value = value * 10 + (*p - '0');
+            }
+        }
+
+        for (size_t i = 0; i < count; ++i) {
+            int code = values[i];
+            if (code == 0) {
+                color = DefaultColor;
+                paletteIndex = -1;
+                bold = false;
+            }
+            else if (code == 1 || code == 22) {
+                bold = code == 1;
+                if (paletteIndex >= 0 && paletteIndex < 8) {
+                    color = paletteColor(paletteIndex + (bold ? 8 : 0));
+                }
+            }
+            else if (code >= 30 && code <= 37) {
+                paletteIndex = code - 30;
+                color = paletteColor(paletteIndex + (bold ? 8 : 0));
+            }
+            else if (code >= 90 && code <= 97) {
+                paletteIndex = code - 90 + 8;
+                color = paletteColor(paletteIndex);
+            }
+            else if (code == 39) {
+                color = DefaultColor;
+                paletteIndex = -1;
+            }
+            else if (code == 38 || code == 48) {
+                //  : 5;n  2;r;g;b ( 48    )
+                if (i + 2 < count && values[i + 1] == 5) {
+                    if (code == 38) {
+                        color = extendedColor(values[i + 2]);
+                        paletteIndex = -1;
+                    }
+                    i += 2;
+                }
+                else if (i + 4 < count && values[i + 1] == 2) {
+                    if (code == 38) {
+                        color = rgba(values[i + 2], values[i + 3], values[i + 4]);
+                        paletteIndex = -1;
+                    }
+                    i += 4;
+                }
+            }
+        }
+    }
+
+    //   (0-7 , 8-15 ),    
+    static uint32_t paletteColor(int index) {
+        static const uint32_t palette[16] = {
+            rgba(0x66, 0x66, 0x66), rgba(0xCD, 0x31, 0x31), rgba(0x0D, 0xBC, 0x79), rgba(0xE5, 0xE5, 0x10),
+            rgba(0x24, 0x72, 0xC8), rgba(0xBC, 0x3F, 0xBC), rgba(0x11, 0xA8, 0xCD), rgba(0xE5, 0xE5, 0xE5),
+            rgba(0x76, 0x76, 0x76), rgba(0xF1, 0x4C, 0x4C), rgba(0x23, 0xD1, 0x8B), rgba(0xF5, 0xF5, 0x43),
+            rgba(0x3B, 0x8E, 0xEA), rgba(0xD6, 0x70, 0xD6), rgba(0x29, 0xB8, 0xDB), rgba(0xFF, 0xFF, 0xFF)
+        };
+        return palette[index & 15];
+    }
+
+    // 256- : 16 ,  6x6x6  24  
+    static uint32_t extendedColor(int index) {
+        if (index < 16) {
+            return paletteColor(index);
+        }
+        if (index < 232) {
+            static const int levels[6] = { 0, 95, 135, 175, 215, 255 };
+            index -= 16;
+            return rgba(levels[index / 36 % 6], levels[index / 6 % 6], levels[index % 6]);
+        }
+        int gray = 8 + 10 * ((index - 232) % 24);
+        return rgba(gray, gray, gray);
+    }
+};
\ No newline at end of file
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <deque>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "LzCodec.h"
+
+//     .
+//  UI     (   )  
+//  ,   .      ,
+//         ,   
+class ChunkPacker {
+public:
+    struct Job {
+        uint64_t firstId;           //   
+        std::vector<char> segment;
+    };
+
+    struct Result {
+        uint64_t firstId;
+        size_t segmentBytes;
+        std::unique_ptr<char[]> packed;
+        size_t packedBytes;         // 0 -    
+    };
+
+private:
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::deque<Job> jobs;
+    std::deque<Result> results;
+    bool stopping;
+
+public:
+    ChunkPacker() : stopping(false) {}
+
+    ~ChunkPacker() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_one();
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+
+    ChunkPacker(const ChunkPacker&) = delete;
+    ChunkPacker& operator=(const ChunkPacker&) = delete;
+
+    //     .     
+    void submit(Job&& job) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            jobs.push_back(std::move(job));
+        }
+        if (!worker.joinable()) {
+            worker = std::thread([this]() { run(); });
+        }
+        wake.notify_one();
+    }
+
+    //   ,   
+    bool poll(Result& result) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (results.empty()) {
+            return false;
+        }
+        result = std::move(results.front());
+        results.pop_front();
+        return true;
+    }
+
+    //  ,    ,    
+    void cancel() {
+        std::lock_guard<std::mutex> lock(mutex);
+        jobs.clear();
+        results.clear();
+    }
+
+private:
+    void run() {
+        std::vector<char> buffer;
+        while (true) {
+            Job job;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [this]() { return stopping || !jobs.empty(); });
+                if (stopping) {
+                    return;
+                }
+                job = std::move(jobs.front());
+                jobs.pop_front();
+            }
+
+            buffer.resize(LzCodec::compressBound(job.segment.size()));
+            size_t length = LzCodec::compress(job.segment.data(), job.segment.size(), buffer.data());
+
+            Result result;
+            result.firstId = job.firstId;
+            result.segmentBytes = job.segment.size();
+            result.packedBytes = 0;
+            //          
+            if (length < job.segment.size() - job.segment.size() / 4) {
+                result.packed.reset(new char[length]);
+                memcpy(result.packed.get(), buffer.data(), length);
+                result.packedBytes = length;
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            results.push_back(std::move(result));
+        }
+    }
+};
\ No newline at end of file
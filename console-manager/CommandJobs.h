@@ -0,0 +1,237 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <cstddef>
+#include <cstdint>
+
+//    .    cancelled()  
+//    ;    
+class CancelToken {
+private:
+    std::shared_ptr<const std::atomic<bool>> flag;
+
+public:
+    CancelToken() {}
+    explicit CancelToken(std::shared_ptr<const std::atomic<bool>> flag) : flag(std::move(flag)) {}
+
+    bool cancelled() const {
+        return flag && flag->load(std::memory_order_relaxed);
+    }
+};
+
+//       .
+//     ,    ;  
+//         MaxQueued.    
+//  Logger ( ),   UI     
+//     poll()
+class CommandJobs {
+public:
+    static const size_t MaxQueued = 64;
+
+    using Work = std::function<void(const CancelToken&)>;
+
+    //     
+    struct JobInfo {
+        uint32_t id;
+        std::string command;
+        bool running;               // false -   
+        bool cancelling;
+        double seconds;             //    (    )
+    };
+
+    //   
+    struct Finished {
+        uint32_t id;
+        std::string command;
+        bool cancelled;
+        std::string error;          //  ,     
+        double seconds;
+    };
+
+private:
+    struct Job {
+        uint32_t id;
+        std::string command;
+        Work work;
+        std::shared_ptr<std::atomic<bool>> cancelled;
+        bool running = false;
+        std::chrono::steady_clock::time_point started;
+    };
+
+    size_t maxWorkers;
+    std::vector<std::thread> workers;
+    size_t idleWorkers;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::deque<std::shared_ptr<Job>> queue;
+    std::vector<std::shared_ptr<Job>> active;
+    std::deque<Finished> finished;
+    uint32_t nextId;
+    bool stopping;
+
+public:
+    CommandJobs() :
+        maxWorkers(std::thread::hardware_concurrency() > 1 ? std::thread::hardware_concurrency() : 2),
+        idleWorkers(0),
+        nextId(1),
+        stopping(false) {
+        if (maxWorkers > 4) {
+            maxWorkers = 4;
+        }
+    }
+
+    ~CommandJobs() {
+        stop();
+    }
+
+    CommandJobs(const CommandJobs&) = delete;
+    CommandJobs& operator=(const CommandJobs&) = delete;
+
+    //    . false -     
+    bool submit(const std::string& command, Work work, uint32_t& id, std::string& error) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (stopping) {
+            error = u8"  ";
+            return false;
+        }
+        if (queue.size() >= MaxQueued) {
+            error = u8"   ";
+            return false;
+        }
+        std::shared_ptr<Job> job = std::make_shared<Job>();
+        job->id = nextId++;
+        job->command = command;
+        job->work = std::move(work);
+        job->cancelled = std::make_shared<std::atomic<bool>>(false);
+        job->started = std::chrono::steady_clock::now();
+        queue.push_back(job);
+        id = job->id;
+
+        if (idleWorkers < queue.size() && workers.size() < maxWorkers) {
+            workers.emplace_back([this]() { run(); });
+        }
+        wake.notify_one();
+        return true;
+    }
+
+    //   .     ,
+    //  - ,    
+    bool cancel(uint32_t id) {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (auto it = queue.begin(); it != queue.end(); ++it) {
+            if ((*it)->id == id) {
+                finished.push_back(finish(**it, true, std::string()));
+                queue.erase(it);
+                return true;
+            }
+        }
+        for (const auto& job : active) {
+            if (job->id == id) {
+                job->cancelled->store(true);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    //    
+    std::vector<JobInfo> list() {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::vector<JobInfo> result;
+        for (const auto& job : active) {
+            result.push_back(info(*job));
+        }
+        for (const auto& job : queue) {
+            result.push_back(info(*job));
+        }
+        return result;
+    }
+
+    //     ,   
+    bool poll(Finished& result) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (finished.empty()) {
+            return false;
+        }
+        result = std::move(finished.front());
+        finished.pop_front();
+        return true;
+    }
+
+    //       
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+            queue.clear();
+            for (const auto& job : active) {
+                job->cancelled->store(true);
+            }
+        }
+        wake.notify_all();
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+        workers.clear();
+    }
+
+private:
+    void run() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            ++idleWorkers;
+            wake.wait(lock, [this]() { return stopping || !queue.empty(); });
+            --idleWorkers;
+            if (stopping) {
+                return;
+            }
+            std::shared_ptr<Job> job = queue.front();
+            queue.pop_front();
+            job->running = true;
+            job->started = std::chrono::steady_clock::now();
+            active.push_back(job);
+            lock.unlock();
+
+            std::string error;
+            try {
+                job->work(CancelToken(job->cancelled));
+            }
+            catch (const std::exception& e) {
+                error = e.what();
+            }
+
+            lock.lock();
+            for (auto it = active.begin(); it != active.end(); ++it) {
+                if (*it == job) {
+                    active.erase(it);
+                    break;
+                }
+            }
+            finished.push_back(finish(*job, job->cancelled->load(), error));
+        }
+    }
+
+    static JobInfo info(const Job& job) {
+        JobInfo result = { job.id, job.command, job.running, job.cancelled->load(), elapsed(job) };
+        return result;
+    }
+
+    static Finished finish(const Job& job, bool cancelled, const std::string& error) {
+        Finished result = { job.id, job.command, cancelled, error, elapsed(job) };
+        return result;
+    }
+
+    static double elapsed(const Job& job) {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - job.started).count();
+    }
+};
\ No newline at end of file
@@ -0,0 +1,208 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstddef>
+
+//  :       .
+// ,   
+class CommandArgs {
+private:
+    const std::string_view* args;
+    size_t argCount;
+
+public:
+    CommandArgs() : args(nullptr), argCount(0) {}
+    CommandArgs(const std::string_view* args, size_t count) : args(args), argCount(count) {}
+
+    //     (;  ,   )
+    std::string getArg(size_t index) const {
+        return std::string(view(index));
+    }
+
+    //      
+    std::string_view view(size_t index) const {
+        if (index < argCount) {
+            return args[index];
+        }
+        return std::string_view();
+    }
+
+    //   
+    const std::string_view* begin() const { return args; }
+    const std::string_view* end() const { return args + argCount; }
+
+    //   
+    size_t count() const {
+        return argCount;
+    }
+};
+
+//     .
+//     .   "..."  '...'   
+//   ;          
+//  ( "..." -   ,  '...'  ).  
+//     ,   Windows    .
+//  '|'       : "cat log.txt | grep error".
+//      ,   -   ;
+//       
+class CommandLine {
+public:
+    static const size_t InlineText = 256;
+    static const size_t InlineTokens = 16;
+    static const size_t MaxStages = 8;
+
+private:
+    char inlineText[InlineText];
+    std::string longText;
+    std::string_view inlineTokens[InlineTokens];
+    std::vector<std::string_view> longTokens;
+    const std::string_view* tokens;
+    size_t tokenCount;
+    size_t stageStarts[MaxStages];  //     
+    size_t stageCount;
+
+public:
+    CommandLine() : tokens(inlineTokens), tokenCount(0), stageCount(0) {}
+
+    CommandLine(const CommandLine&) = delete;
+    CommandLine& operator=(const CommandLine&) = delete;
+
+    //  .   ,     
+    //    false     error
+    bool parse(std::string_view line, const char*& error) {
+        //         
+        char* out = inlineText;
+        if (line.size() > InlineText) {
+            longText.resize(line.size());
+            out = &longText[0];
+        }
+        longTokens.clear();
+        tokenCount = 0;
+        stageStarts[0] = 0;
+        stageCount = 1;
+
+        const char* p = line.data();
+        const char* end = p + line.size();
+        while (true) {
+            while (p < end && isSpace(*p)) {
+                ++p;
+            }
+            if (p == end) {
+                break;
+            }
+            if (*p == '|') {
+                if (tokenCount == stageStarts[stageCount - 1]) {
+                    return fail(error, u8"   ");
+                }
+                if (stageCount == MaxStages) {
+                    return fail(error, u8"    ");
+                }
+                stageStarts[stageCount++] = tokenCount;
+                ++p;
+                continue;
+            }
+
+            char* token = out;
+            char quote = 0;
+            while (p < end) {
+                char c = *p;
+                if (quote) {
+                    if (c == quote) {
+                        quote = 0;
+                    }
+                    else if (c == '\\' && quote == '"' && p + 1 < end && p[1] == '"') {
+                        *out++ = '"';
+                        ++p;
+                    }
+                    else {
+                        *out++ = c;
+                    }
+                }
+                else if (isSpace(c) || c == '|') {
+                    break;
+                }
+                else if (c == '"' || c == '\'') {
+                    quote = c;
+                }
+                else if (c == '\\' && p + 1 < end && (isSpace(p[1]) || p[1] == '"' || p[1] == '\'' || p[1] == '|')) {
+                    *out++ = p[1];
+                    ++p;
+                }
+                else {
+                    *out++ = c;
+                }
+                ++p;
+            }
+            if (quote) {
+                return fail(error, u8" ");
+            }
+            push(std::string_view(token, static_cast<size_t>(out - token)));
+        }
+        if (stageCount > 1 && tokenCount == stageStarts[stageCount - 1]) {
+            return fail(error, u8"   ");
+        }
+
+        tokens = longTokens.empty() ? inlineTokens : longTokens.data();
+        return true;
+    }
+
+    size_t count() const { return tokenCount; }
+    bool empty() const { return tokenCount == 0; }
+
+    std::string_view operator[](size_t index) const {
+        return tokens[index];
+    }
+
+    //   -   (    )
+    std::string_view name() const {
+        return tokens[0];
+    }
+
+    //   -       
+    CommandArgs args() const {
+        return tokenCount > 0 ? stageArgs(0) : CommandArgs();
+    }
+
+    //    (1 -  , 0 -  )
+    size_t stages() const {
+        return tokenCount > 0 ? stageCount : 0;
+    }
+
+    //    index
+    std::string_view stageName(size_t index) const {
+        return tokens[stageStarts[index]];
+    }
+
+    //    index
+    CommandArgs stageArgs(size_t index) const {
+        size_t first = stageStarts[index] + 1;
+        size_t last = index + 1 < stageCount ? stageStarts[index + 1] : tokenCount;
+        return CommandArgs(tokens + first, last - first);
+    }
+
+private:
+    bool fail(const char*& error, const char* message) {
+        error = message;
+        tokenCount = 0;
+        stageCount = 1;
+        return false;
+    }
+
+    static bool isSpace(char c) {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+    }
+
+    void push(std::string_view token) {
+        if (tokenCount < InlineTokens) {
+            inlineTokens[tokenCount++] = token;
+            return;
+        }
+        if (longTokens.empty()) {
+            longTokens.assign(inlineTokens, inlineTokens + InlineTokens);
+        }
+        longTokens.push_back(token);
+        ++tokenCount;
+    }
+};
\ No newline at end of file
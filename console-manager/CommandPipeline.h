@@ -0,0 +1,426 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <exception>
+#include <stdexcept>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+#include "CommandLine.h"
+#include "CommandJobs.h"
+#include "LineBatcher.h"
+
+//      .
+//     BatchBytes,     MaxBatches :
+//    ,        .
+//        
+class LinePipe {
+public:
+    static const size_t BatchBytes = 64 * 1024;
+    static const size_t MaxBatches = 4;
+
+private:
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::deque<std::string> batches;
+    std::vector<std::string> spare;
+    bool writerClosed;
+    bool readerClosed;
+
+public:
+    LinePipe() : writerClosed(false), readerClosed(false) {}
+
+    LinePipe(const LinePipe&) = delete;
+    LinePipe& operator=(const LinePipe&) = delete;
+
+    //  ,  . false -      .
+    //  batch      
+    bool push(std::string& batch, const CancelToken& token) {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (batches.size() >= MaxBatches && !readerClosed) {
+            if (!wait(lock, token)) {
+                return false;
+            }
+        }
+        if (readerClosed) {
+            return false;
+        }
+        batches.push_back(std::move(batch));
+        batch.clear();
+        if (!spare.empty()) {
+            batch.swap(spare.back());
+            spare.pop_back();
+        }
+        changed.notify_all();
+        return true;
+    }
+
+    //   . false -      
+    //   .   batch  
+    bool pop(std::string& batch, const CancelToken& token) {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (batches.empty() && !writerClosed) {
+            if (!wait(lock, token)) {
+                return false;
+            }
+        }
+        if (batches.empty()) {
+            return false;
+        }
+        if (batch.capacity() > 0 && spare.size() < MaxBatches) {
+            batch.clear();
+            spare.push_back(std::move(batch));
+        }
+        batch = std::move(batches.front());
+        batches.pop_front();
+        changed.notify_all();
+        return true;
+    }
+
+    //     
+    bool accepting() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return !readerClosed;
+    }
+
+    //   ,     
+    bool ready() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return !batches.empty() || writerClosed;
+    }
+
+    void closeWriter() {
+        std::lock_guard<std::mutex> lock(mutex);
+        writerClosed = true;
+        changed.notify_all();
+    }
+
+    //     :    
+    void closeReader() {
+        std::lock_guard<std::mutex> lock(mutex);
+        readerClosed = true;
+        batches.clear();
+        changed.notify_all();
+    }
+
+private:
+    //      (    )
+    bool wait(std::unique_lock<std::mutex>& lock, const CancelToken& token) {
+        if (token.cancelled()) {
+            return false;
+        }
+        changed.wait_for(lock, std::chrono::milliseconds(50));
+        return true;
+    }
+};
+
+//   :     ,   ,  
+class LineWriter {
+private:
+    LinePipe* pipe;
+    LineBatcher* batcher;
+    const CancelToken& token;
+    std::string batch;
+    bool closed;
+
+public:
+    LineWriter(LinePipe& pipe, const CancelToken& token) :
+        pipe(&pipe),
+        batcher(nullptr),
+        token(token),
+        closed(false) {}
+
+    LineWriter(LineBatcher& batcher, const CancelToken& token) :
+        pipe(nullptr),
+        batcher(&batcher),
+        token(token),
+        closed(false) {}
+
+    //  . false -     (  )
+    bool write(std::string_view line) {
+        if (closed) {
+            return false;
+        }
+        if (batch.size() + line.size() + 1 > LinePipe::BatchBytes && !batch.empty() && !flush()) {
+            return false;
+        }
+        batch.append(line.data(), line.size());
+        batch.push_back('\n');
+        return !token.cancelled();
+    }
+
+    //    (,   ):   
+    // ,    pending   . '\r'  '\n' 
+    bool writeText(const char* data, size_t length, std::string& pending) {
+        const char* end = data + length;
+        while (data < end) {
+            const char* newline = static_cast<const char*>(memchr(data, '\n', static_cast<size_t>(end - data)));
+            if (!newline) {
+                pending.append(data, end);
+                break;
+            }
+            std::string_view line(data, static_cast<size_t>(newline - data));
+            if (!pending.empty()) {
+                pending.append(line.data(), line.size());
+                line = pending;
+            }
+            if (!line.empty() && line.back() == '\r') {
+                line.remove_suffix(1);
+            }
+            bool accepted = write(line);
+            pending.clear();
+            if (!accepted) {
+                return false;
+            }
+            data = newline + 1;
+        }
+        return true;
+    }
+
+    //    . false -    
+    bool flush() {
+        if (closed) {
+            return false;
+        }
+        if (batch.empty()) {
+            closed = pipe && !pipe->accepting();
+            return !closed;
+        }
+        if (batcher) {
+            memcpy(batcher->reserve(batch.size()), batch.data(), batch.size());
+            batcher->commit(batch.size());
+            batch.clear();
+            return true;
+        }
+        closed = !pipe->push(batch, token);
+        return !closed;
+    }
+
+    //  :     
+    void finish() {
+        flush();
+        closed = true;
+        if (pipe) {
+            pipe->closeWriter();
+        }
+        else {
+            batcher->finish();
+        }
+    }
+};
+
+//   :    '\n'.
+//       ,   
+// (,  tail)     
+class LineReader {
+private:
+    LinePipe* pipe;             // nullptr -     
+    LineWriter* output;
+    const CancelToken& token;
+    std::string batch;
+    size_t position;
+
+public:
+    LineReader(LinePipe* pipe, LineWriter* output, const CancelToken& token) :
+        pipe(pipe),
+        output(output),
+        token(token),
+        position(0) {}
+
+    //  ;    . false -  
+    bool next(std::string_view& line) {
+        while (position >= batch.size()) {
+            if (!pipe) {
+                return false;
+            }
+            if (output && !pipe->ready()) {
+                output->flush();
+            }
+            if (!pipe->pop(batch, token)) {
+                return false;
+            }
+            position = 0;
+        }
+        const char* begin = batch.data() + position;
+        const char* newline = static_cast<const char*>(memchr(begin, '\n', batch.size() - position));
+        size_t length = newline ? static_cast<size_t>(newline - begin) : batch.size() - position;
+        line = std::string_view(begin, length);
+        position += length + 1;
+        return true;
+    }
+
+    //  :       
+    void close() {
+        if (pipe) {
+            pipe->closeReader();
+        }
+    }
+};
+
+//      LineBatcher (reserve/commit/finish/discard)
+//   :  FileFollower     
+class LineTextSink {
+private:
+    LineWriter& output;
+    std::vector<char> block;
+    std::string pending;        //   
+    bool closed;
+
+public:
+    explicit LineTextSink(LineWriter& output) : output(output), closed(false) {}
+
+    char* reserve(size_t length) {
+        if (block.size() < length) {
+            block.resize(length);
+        }
+        return block.data();
+    }
+
+    void commit(size_t length) {
+        if (!closed && !output.writeText(block.data(), length, pending)) {
+            closed = true;
+        }
+    }
+
+    //   (,  ):   
+    void finish() {
+        if (!pending.empty() && !closed && !output.write(pending)) {
+            closed = true;
+        }
+        pending.clear();
+    }
+
+    void discard() {
+        pending.clear();
+    }
+
+    //    . false -    
+    bool flush() {
+        if (!closed && !output.flush()) {
+            closed = true;
+        }
+        return !closed;
+    }
+};
+
+//       cat
+class FileLineSource {
+public:
+    static const size_t ReadBlock = 256 * 1024;
+
+private:
+    FILE* file;
+    std::vector<char> block;
+    std::string pending;        //   
+
+public:
+    FileLineSource() : file(nullptr) {}
+
+    ~FileLineSource() {
+        if (file) {
+            fclose(file);
+        }
+    }
+
+    FileLineSource(const FileLineSource&) = delete;
+    FileLineSource& operator=(const FileLineSource&) = delete;
+
+    bool open(const std::string& path, std::string& error) {
+        file = fopen(path.c_str(), "rb");
+        if (!file) {
+            error = u8"    " + path + ": " + strerror(errno);
+            return false;
+        }
+        block.resize(ReadBlock);
+        return true;
+    }
+
+    //   output ,     . false -  
+    bool readAvailable(LineWriter& output, const CancelToken& token) {
+        size_t got;
+        while ((got = fread(block.data(), 1, block.size(), file)) > 0) {
+            if (!output.writeText(block.data(), got, pending) || token.cancelled()) {
+                return false;
+            }
+        }
+        clearerr(file);
+        return true;
+    }
+
+    //    
+    bool finish(LineWriter& output) {
+        if (pending.empty()) {
+            return true;
+        }
+        bool accepted = output.write(pending);
+        pending.clear();
+        return accepted;
+    }
+};
+
+//   "a | b | c":        
+//         
+class CommandPipeline {
+public:
+    using StageFunction = std::function<void(const CommandArgs& args, LineReader& input, LineWriter& output,
+        const CancelToken& token)>;
+
+    struct Stage {
+        StageFunction function;
+        std::vector<std::string> args;
+    };
+
+    //  ;      output.  
+    //    .      
+    static void run(const std::vector<Stage>& stages, LineWriter& output, const CancelToken& token) {
+        std::vector<std::unique_ptr<LinePipe>> pipes;
+        for (size_t i = 0; i + 1 < stages.size(); ++i) {
+            pipes.emplace_back(new LinePipe());
+        }
+
+        std::mutex errorMutex;
+        std::string error;
+        auto runStage = [&](size_t index, LineWriter& writer) {
+            LineReader reader(index > 0 ? pipes[index - 1].get() : nullptr, &writer, token);
+            std::vector<std::string_view> views(stages[index].args.begin(), stages[index].args.end());
+            try {
+                stages[index].function(CommandArgs(views.data(), views.size()), reader, writer, token);
+            }
+            catch (const std::exception& e) {
+                std::lock_guard<std::mutex> lock(errorMutex);
+                if (error.empty()) {
+                    error = e.what();
+                }
+            }
+            writer.finish();
+            reader.close();
+        };
+
+        std::vector<std::thread> threads;
+        for (size_t i = 0; i + 1 < stages.size(); ++i) {
+            threads.emplace_back([&, i]() {
+                LineWriter writer(*pipes[i], token);
+                runStage(i, writer);
+            });
+        }
+        runStage(stages.size() - 1, output);
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+        if (!error.empty()) {
+            throw std::runtime_error(error);
+        }
+    }
+};
\ No newline at end of file
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <functional>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cerrno>
+#include <cstring>
+
+#include "CommandLine.h"
+#include "CommandPipeline.h"
+
+//  ,    .
+//        :   
+//       (    ),
+//           .
+//     (next),      
+class CommandScript {
+public:
+    using Function = std::function<void(const CommandArgs&)>;
+
+    struct Instruction {
+        const Function* function;       // nullptr - 
+        uint32_t pipeline;              //   ( )
+        uint32_t firstArg;
+        uint32_t argCount;
+        uint32_t line;                  //    ( 1)
+    };
+
+    //  :        
+    struct Pipeline {
+        std::vector<CommandPipeline::Stage> stages;
+        std::string command;
+    };
+
+private:
+    struct Span {
+        uint32_t offset;
+        uint32_t length;
+    };
+
+    std::string path;
+    std::string text;                   //    
+    std::vector<Span> spans;            //   finish()
+    std::vector<std::string_view> args; //   finish()
+    std::vector<Instruction> instructions;
+    std::vector<Pipeline> pipelines;
+    size_t position;                    //  
+
+public:
+    explicit CommandScript(const std::string& path) : path(path), position(0) {}
+
+    CommandScript(const CommandScript&) = delete;
+    CommandScript& operator=(const CommandScript&) = delete;
+
+    //    
+    static bool readFile(const std::string& path, std::string& content, std::string& error) {
+        FILE* file = fopen(path.c_str(), "rb");
+        if (!file) {
+            error = u8"    " + path + ": " + strerror(errno);
+            return false;
+        }
+        char block[64 * 1024];
+        size_t got;
+        while ((got = fread(block, 1, sizeof(block), file)) > 0) {
+            content.append(block, got);
+        }
+        bool failed = ferror(file) != 0;
+        fclose(file);
+        if (failed) {
+            error = u8"   " + path;
+            return false;
+        }
+        return true;
+    }
+
+    //      args
+    void addCommand(const Function* function, const CommandArgs& commandArgs, uint32_t line) {
+        Instruction instruction = { function, 0, static_cast<uint32_t>(spans.size()),
+            static_cast<uint32_t>(commandArgs.count()), line };
+        for (std::string_view arg : commandArgs) {
+            Span span = { static_cast<uint32_t>(text.size()), static_cast<uint32_t>(arg.size()) };
+            text.append(arg.data(), arg.size());
+            spans.push_back(span);
+        }
+        instructions.push_back(instruction);
+    }
+
+    //   
+    void addPipeline(Pipeline&& pipeline, uint32_t line) {
+        Instruction instruction = { nullptr, static_cast<uint32_t>(pipelines.size()), 0, 0, line };
+        pipelines.push_back(std::move(pipeline));
+        instructions.push_back(instruction);
+    }
+
+    //  :    ,      
+    void finish() {
+        args.reserve(spans.size());
+        for (const Span& span : spans) {
+            args.emplace_back(text.data() + span.offset, span.length);
+        }
+        spans.clear();
+        spans.shrink_to_fit();
+    }
+
+    const std::string& getPath() const { return path; }
+    size_t size() const { return instructions.size(); }
+    size_t executed() const { return position; }
+    bool done() const { return position == instructions.size(); }
+
+    //   (      )
+    const Instruction& next() {
+        return instructions[position++];
+    }
+
+    //  ; ,   
+    CommandArgs argsOf(const Instruction& instruction) const {
+        return CommandArgs(args.data() + instruction.firstArg, instruction.argCount);
+    }
+
+    const Pipeline& pipelineOf(const Instruction& instruction) const {
+        return pipelines[instruction.pipeline];
+    }
+};
\ No newline at end of file
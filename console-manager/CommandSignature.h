@@ -0,0 +1,343 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <optional>
+#include <tuple>
+#include <utility>
+#include <charconv>
+#include <type_traits>
+#include <initializer_list>
+#include <cstddef>
+
+#include "CommandLine.h"
+#include "CommandJobs.h"
+
+//     .    
+//  ,   0:
+//     template <> struct CommandEnum<Mode> { static constexpr const char* names[] = { "fast", "safe" }; };
+template <typename E>
+struct CommandEnum;
+
+//      : parse()     
+//  ( std::string), label() -        
+template <typename T, typename = void>
+struct CommandArg;
+
+template <typename T>
+struct CommandArg<T, std::enable_if_t<std::is_integral<T>::value && !std::is_same<T, bool>::value>> {
+    static bool parse(std::string_view text, T& value) {
+        const char* end = text.data() + text.size();
+        std::from_chars_result result = std::from_chars(text.data(), end, value);
+        return result.ec == std::errc() && result.ptr == end && !text.empty();
+    }
+
+    static void label(std::string& out) {
+        out += std::is_signed<T>::value ? u8" " : u8"  ";
+    }
+};
+
+template <>
+struct CommandArg<double> {
+    static bool parse(std::string_view text, double& value) {
+        const char* end = text.data() + text.size();
+        std::from_chars_result result = std::from_chars(text.data(), end, value);
+        return result.ec == std::errc() && result.ptr == end && !text.empty();
+    }
+
+    static void label(std::string& out) {
+        out += u8"";
+    }
+};
+
+template <>
+struct CommandArg<std::string_view> {
+    static bool parse(std::string_view text, std::string_view& value) {
+        value = text;
+        return true;
+    }
+
+    static void label(std::string& out) {
+        out += u8"";
+    }
+};
+
+template <>
+struct CommandArg<std::string> {
+    static bool parse(std::string_view text, std::string& value) {
+        value.assign(text.data(), text.size());
+        return true;
+    }
+
+    static void label(std::string& out) {
+        out += u8"";
+    }
+};
+
+template <typename T>
+struct CommandArg<T, std::enable_if_t<std::is_enum<T>::value>> {
+    //      
+    static bool parse(std::string_view text, T& value) {
+        size_t index = 0;
+        for (const char* name : CommandEnum<T>::names) {
+            if (sameName(text, name)) {
+                value = static_cast<T>(index);
+                return true;
+            }
+            ++index;
+        }
+        return false;
+    }
+
+    static void label(std::string& out) {
+        bool first = true;
+        for (const char* name : CommandEnum<T>::names) {
+            if (!first) {
+                out += '|';
+            }
+            out += name;
+            first = false;
+        }
+    }
+
+private:
+    static bool sameName(std::string_view text, const char* name) {
+        size_t i = 0;
+        for (; i < text.size() && name[i] != '\0'; ++i) {
+            char c = text[i];
+            if (c >= 'A' && c <= 'Z') {
+                c = static_cast<char>(c - 'A' + 'a');
+            }
+            if (c != name[i]) {
+                return false;
+            }
+        }
+        return i == text.size() && name[i] == '\0';
+    }
+};
+
+//    .
+//      ;    
+//     .  , double, std::string_view, std::string,
+//   CommandEnum, std::optional<T> ( )  CommandArgs
+//   (  ). ,    -
+// CancelToken,   :   ,   -  
+template <typename Callback>
+class CommandSignature {
+public:
+    // ,       
+    struct Error {
+        enum Kind { None, Missing, Invalid, Extra };
+        Kind kind = None;
+        size_t index = 0;           //    ( Invalid)
+    };
+
+private:
+    template <typename T>
+    struct Param {
+        using Value = T;
+        static const bool optional = false;
+    };
+
+    template <typename T>
+    struct Param<std::optional<T>> {
+        using Value = T;
+        static const bool optional = true;
+    };
+
+    template <typename T, typename = void>
+    struct Parameters : Parameters<decltype(&T::operator())> {};
+
+    template <typename C, typename R, typename... Args>
+    struct Parameters<R (C::*)(Args...) const> {
+        using Tuple = std::tuple<std::decay_t<Args>...>;
+    };
+
+    template <typename C, typename R, typename... Args>
+    struct Parameters<R (C::*)(Args...)> {
+        using Tuple = std::tuple<std::decay_t<Args>...>;
+    };
+
+    template <typename R, typename... Args>
+    struct Parameters<R (*)(Args...)> {
+        using Tuple = std::tuple<std::decay_t<Args>...>;
+    };
+
+public:
+    using Tuple = typename Parameters<Callback>::Tuple;
+
+private:
+    static const size_t ParamCount = std::tuple_size<Tuple>::value;
+
+    template <size_t I>
+    using ParamType = std::tuple_element_t<I, Tuple>;
+
+    template <size_t I>
+    static constexpr bool isRest() {
+        return std::is_same<ParamType<I>, CommandArgs>::value;
+    }
+
+    template <size_t... I>
+    static constexpr bool restIsLast(std::index_sequence<I...>) {
+        bool valid = true;
+        ((valid = valid && (!isRest<I>() || I + 1 == argCount())), ...);
+        return valid;
+    }
+
+    //      ,    
+    template <size_t... I>
+    static constexpr bool ownsArguments(std::index_sequence<I...>) {
+        return (true && ... && (!isRest<I>() && !std::is_same<typename Param<ParamType<I>>::Value, std::string_view>::value));
+    }
+
+    //  ,    ( CancelToken)
+    static constexpr size_t argCount() {
+        return isAsync() ? ParamCount - 1 : ParamCount;
+    }
+
+    //   :     
+    template <size_t... I>
+    static constexpr size_t requiredCount(std::index_sequence<I...>) {
+        size_t count = 0;
+        ((count = !Param<ParamType<I>>::optional && !isRest<I>() ? I + 1 : count), ...);
+        return count;
+    }
+
+    template <size_t... I>
+    static constexpr bool takesRest(std::index_sequence<I...>) {
+        return (false || ... || isRest<I>());
+    }
+
+public:
+    //      (  - CancelToken)
+    static constexpr bool isAsync() {
+        if constexpr (ParamCount == 0) {
+            return false;
+        }
+        else {
+            return std::is_same<ParamType<ParamCount - 1>, CancelToken>::value;
+        }
+    }
+
+    //    values.    false  
+    static bool parse(const CommandArgs& args, Tuple& values, Error& error) {
+        static_assert(restIsLast(std::make_index_sequence<argCount()>()),
+            "CommandArgs can only be the last command parameter");
+        static_assert(!isAsync() || ownsArguments(std::make_index_sequence<argCount()>()),
+            "Background commands take std::string instead of std::string_view or CommandArgs");
+        constexpr size_t minArgs = requiredCount(std::make_index_sequence<argCount()>());
+        constexpr bool variadic = takesRest(std::make_index_sequence<argCount()>());
+        if (args.count() < minArgs) {
+            error.kind = Error::Missing;
+            return false;
+        }
+        if (!variadic && args.count() > argCount()) {
+            error.kind = Error::Extra;
+            return false;
+        }
+        return bindAll(args, values, error, std::make_index_sequence<argCount()>());
+    }
+
+    //  callback    (     )
+    static void call(const Callback& callback, Tuple&& values, const CancelToken& token = CancelToken()) {
+        if constexpr (isAsync()) {
+            std::get<ParamCount - 1>(values) = token;
+        }
+        std::apply(callback, std::move(values));
+    }
+
+    //     callback.    false  
+    static bool invoke(const Callback& callback, const CommandArgs& args, Error& error) {
+        Tuple values;
+        if (!parse(args, values, error)) {
+            return false;
+        }
+        call(callback, std::move(values));
+        return true;
+    }
+
+    //  : "name <a> <b> [c] [d...]".     names
+    //   
+    static std::string usage(const std::string& name, std::initializer_list<const char*> names) {
+        std::string out = name;
+        appendUsage(out, names, std::make_index_sequence<argCount()>());
+        return out;
+    }
+
+    //   index:   names  
+    static std::string paramName(size_t index, std::initializer_list<const char*> names) {
+        std::string out;
+        if (index < names.size()) {
+            out = names.begin()[index];
+        }
+        else {
+            appendTypeLabel(out, index, std::make_index_sequence<argCount()>());
+        }
+        return out;
+    }
+
+    //   index    
+    static std::string typeLabel(size_t index) {
+        std::string out;
+        appendTypeLabel(out, index, std::make_index_sequence<argCount()>());
+        return out;
+    }
+
+private:
+    template <size_t... I>
+    static bool bindAll(const CommandArgs& args, Tuple& values, Error& error, std::index_sequence<I...>) {
+        bool bound = true;
+        ((bound = bound && bind<I>(args, std::get<I>(values), error)), ...);
+        return bound;
+    }
+
+    template <size_t I, typename T>
+    static bool bind(const CommandArgs& args, T& value, Error& error) {
+        if constexpr (isRest<I>()) {
+            value = I < args.count() ? CommandArgs(args.begin() + I, args.count() - I) : CommandArgs();
+            return true;
+        }
+        else {
+            using Value = typename Param<T>::Value;
+            if (I >= args.count()) {
+                return true;        //    
+            }
+            Value parsed{};
+            if (!CommandArg<Value>::parse(args.view(I), parsed)) {
+                error.kind = Error::Invalid;
+                error.index = I;
+                return false;
+            }
+            value = std::move(parsed);
+            return true;
+        }
+    }
+
+    template <size_t... I>
+    static void appendUsage(std::string& out, std::initializer_list<const char*> names, std::index_sequence<I...>) {
+        (appendParamUsage<I>(out, names), ...);
+    }
+
+    template <size_t I>
+    static void appendParamUsage(std::string& out, std::initializer_list<const char*> names) {
+        bool optional = Param<ParamType<I>>::optional || isRest<I>();
+        out += optional ? " [" : " <";
+        out += paramName(I, names);
+        out += isRest<I>() ? "...]" : optional ? "]" : ">";
+    }
+
+    template <size_t... I>
+    static void appendTypeLabel(std::string& out, size_t index, std::index_sequence<I...>) {
+        ((I == index ? appendTypeLabelOf<I>(out) : void()), ...);
+    }
+
+    template <size_t I>
+    static void appendTypeLabelOf(std::string& out) {
+        if constexpr (isRest<I>()) {
+            out += u8"";
+        }
+        else {
+            CommandArg<typename Param<ParamType<I>>::Value>::label(out);
+        }
+    }
+};
\ No newline at end of file
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+//      .
+//     O( )      :
+//     256 ,   .   ,
+//      ,     ,
+//     ,   
+class CommandTrie {
+private:
+    struct Edge {
+        char symbol;
+        uint32_t node;
+    };
+
+    struct Node {
+        std::vector<Edge> children;     //   symbol
+        uint32_t names;                 //    
+        bool terminal;                  //   
+    };
+
+    std::vector<Node> nodes;
+
+public:
+    CommandTrie() : nodes(1) {
+        nodes[0].names = 0;
+        nodes[0].terminal = false;
+    }
+
+    //   (    )
+    void insert(std::string_view name) {
+        uint32_t existing = find(name);
+        if (existing != NotFound && nodes[existing].terminal) {
+            return;
+        }
+        uint32_t node = 0;
+        ++nodes[0].names;
+        for (char symbol : name) {
+            std::vector<Edge>& children = nodes[node].children;
+            auto it = std::lower_bound(children.begin(), children.end(), symbol,
+                [](const Edge& edge, char value) { return edge.symbol < value; });
+            if (it == children.end() || it->symbol != symbol) {
+                Edge edge = { symbol, static_cast<uint32_t>(nodes.size()) };
+                children.insert(it, edge);
+                Node child;
+                child.names = 0;
+                child.terminal = false;
+                nodes.push_back(child);     // children   :    
+                node = edge.node;
+            }
+            else {
+                node = it->node;
+            }
+            ++nodes[node].names;
+        }
+        nodes[node].terminal = true;
+    }
+
+    //  prefix:  extension -       ,
+    //  matches -  maxMatches    .     
+    size_t complete(std::string_view prefix, std::string& extension, std::vector<std::string>& matches,
+        size_t maxMatches) const {
+        extension.clear();
+        matches.clear();
+        uint32_t node = find(prefix);
+        if (node == NotFound) {
+            return 0;
+        }
+        //  : ,        
+        while (!nodes[node].terminal && nodes[node].children.size() == 1) {
+            extension += nodes[node].children[0].symbol;
+            node = nodes[node].children[0].node;
+        }
+        std::string name(prefix);
+        name += extension;
+        collect(node, name, matches, maxMatches);
+        return nodes[node].names;
+    }
+
+private:
+    static const uint32_t NotFound = UINT32_MAX;
+
+    uint32_t find(std::string_view prefix) const {
+        uint32_t node = 0;
+        for (char symbol : prefix) {
+            const std::vector<Edge>& children = nodes[node].children;
+            auto it = std::lower_bound(children.begin(), children.end(), symbol,
+                [](const Edge& edge, char value) { return edge.symbol < value; });
+            if (it == children.end() || it->symbol != symbol) {
+                return NotFound;
+            }
+            node = it->node;
+        }
+        return node;
+    }
+
+    void collect(uint32_t node, std::string& name, std::vector<std::string>& matches, size_t maxMatches) const {
+        if (matches.size() >= maxMatches) {
+            return;
+        }
+        if (nodes[node].terminal) {
+            matches.push_back(name);
+        }
+        for (const Edge& edge : nodes[node].children) {
+            name += edge.symbol;
+            collect(edge.node, name, matches, maxMatches);
+            name.pop_back();
+            if (matches.size() >= maxMatches) {
+                return;
+            }
+        }
+    }
+};
\ No newline at end of file
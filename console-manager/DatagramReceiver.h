@@ -0,0 +1,418 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "Logger.h"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment(lib, "ws2_32.lib")
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#endif
+
+//     (  syslog)   UDP- ,
+//  Windows,  Unix-.   -  ;  "<PRI>"
+//   .  Linux     recvmmsg 
+//  BatchMessages     ,  ,  
+//  ,    
+class DatagramReceiver {
+public:
+    static const size_t BatchMessages = 128;
+    static const size_t MessageBytes = 8192;        //    
+    static const int ReceiveBufferBytes = 8 << 20;  //     
+    static const size_t MaxBatchLines = 64 * BatchMessages;
+
+private:
+    std::shared_ptr<Logger> logger;
+    std::string name;
+    uint16_t channel;
+    std::thread worker;
+    std::atomic<bool> stopping;
+    std::vector<char> buffers;          // BatchMessages   MessageBytes
+#ifdef _WIN32
+    SOCKET socket;
+    bool winsockReady;
+#else
+    int socket;
+    int wakePipe[2];
+    std::string unixPath;
+    dev_t unixDevice;                   //    :
+    ino_t unixInode;                    //        
+#endif
+
+public:
+    DatagramReceiver(std::shared_ptr<Logger> logger) :
+        logger(logger),
+        channel(Logger::ConsoleChannel),
+        stopping(false),
+        buffers(BatchMessages * MessageBytes),
+#ifdef _WIN32
+        socket(INVALID_SOCKET),
+        winsockReady(false) {}
+#else
+        socket(-1),
+        unixDevice(0),
+        unixInode(0) {
+        wakePipe[0] = wakePipe[1] = -1;
+    }
+#endif
+
+    ~DatagramReceiver() {
+        stop();
+#ifdef _WIN32
+        if (socket != INVALID_SOCKET) {
+            closesocket(socket);
+        }
+        if (winsockReady) {
+            WSACleanup();
+        }
+#else
+        if (socket >= 0) {
+            close(socket);
+        }
+        struct stat info;
+        if (!unixPath.empty() && lstat(unixPath.c_str(), &info) == 0 &&
+            info.st_dev == unixDevice && info.st_ino == unixInode) {
+            unlink(unixPath.c_str());
+        }
+        for (int fd : wakePipe) {
+            if (fd >= 0) {
+                close(fd);
+            }
+        }
+#endif
+    }
+
+    DatagramReceiver(const DatagramReceiver&) = delete;
+    DatagramReceiver& operator=(const DatagramReceiver&) = delete;
+
+    //  UDP-  127.0.0.1
+    bool listenUdp(uint16_t port, std::string& error) {
+#ifdef _WIN32
+        WSADATA data;
+        if (WSAStartup(MAKEWORD(2, 2), &data) != 0) {
+            error = u8"   Winsock";
+            return false;
+        }
+        winsockReady = true;
+#endif
+#ifdef _WIN32
+        socket = ::socket(AF_INET, SOCK_DGRAM, 0);
+        //     ,   run,   unlisten
+        if (socket != INVALID_SOCKET) {
+            SetHandleInformation(reinterpret_cast<HANDLE>(socket), HANDLE_FLAG_INHERIT, 0);
+        }
+#else
+        socket = createSocket(AF_INET);
+#endif
+        if (!validSocket()) {
+            error = lastError();
+            return false;
+        }
+        sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(port);
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if (bind(socket, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+            error = lastError();
+            return false;
+        }
+        name = "udp:" + std::to_string(port);
+        return start(error);
+    }
+
+    //  Unix-  ( Windows  ).
+    //   ,    ,    
+    // (   ):        
+    bool listenUnix(const std::string& path, std::string& error) {
+#ifdef _WIN32
+        (void)path;
+        error = u8"Unix-    Windows,  UDP-";
+        return false;
+#else
+        sockaddr_un address = {};
+        if (path.size() >= sizeof(address.sun_path)) {
+            error = u8"  ";
+            return false;
+        }
+        socket = createSocket(AF_UNIX);
+        if (socket < 0) {
+            error = lastError();
+            return false;
+        }
+        address.sun_family = AF_UNIX;
+        std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+        struct stat info;
+        if (lstat(path.c_str(), &info) == 0) {
+            if (!S_ISSOCK(info.st_mode)) {
+                error = path + u8":       ";
+                return false;
+            }
+            if (socketInUse(address)) {
+                error = path + u8":   ";
+                return false;
+            }
+            unlink(path.c_str());
+        }
+        if (bind(socket, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+            error = lastError();
+            return false;
+        }
+        if (lstat(path.c_str(), &info) == 0) {
+            unixDevice = info.st_dev;
+            unixInode = info.st_ino;
+        }
+        unixPath = path;
+        name = "unix:" + path;
+        return start(error);
+#endif
+    }
+
+    void stop() {
+        if (!worker.joinable()) {
+            return;
+        }
+        stopping.store(true);
+#ifndef _WIN32
+        char wake = 0;
+        if (write(wakePipe[1], &wake, 1) < 0) {
+            //        
+        }
+#endif
+        worker.join();
+    }
+
+    //  : "udp:"  "unix:"
+    const std::string& getName() const {
+        return name;
+    }
+
+private:
+    bool validSocket() const {
+#ifdef _WIN32
+        return socket != INVALID_SOCKET;
+#else
+        return socket >= 0;
+#endif
+    }
+
+#ifndef _WIN32
+    //  ,      run: 
+    //  unlisten     ,    
+    static int createSocket(int family) {
+#ifdef __linux__
+        return ::socket(family, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+#else
+        int created = ::socket(family, SOCK_DGRAM, 0);
+        if (created >= 0) {
+            fcntl(created, F_SETFD, FD_CLOEXEC);
+        }
+        return created;
+#endif
+    }
+
+    //   - :      
+    static bool socketInUse(const sockaddr_un& address) {
+        int probe = createSocket(AF_UNIX);
+        if (probe < 0) {
+            return false;
+        }
+        bool connected = connect(probe, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0;
+        close(probe);
+        return connected;
+    }
+#endif
+
+    static std::string lastError() {
+#ifdef _WIN32
+        return u8"  " + std::to_string(WSAGetLastError());
+#else
+        return std::strerror(errno);
+#endif
+    }
+
+    bool start(std::string& error) {
+        int size = ReceiveBufferBytes;
+        setsockopt(socket, SOL_SOCKET, SO_RCVBUF, reinterpret_cast<const char*>(&size), sizeof(size));
+#ifdef _WIN32
+        u_long nonBlocking = 1;
+        ioctlsocket(socket, FIONBIO, &nonBlocking);
+#else
+        fcntl(socket, F_SETFL, O_NONBLOCK);
+#ifdef __linux__
+        int piped = pipe2(wakePipe, O_CLOEXEC);
+#else
+        int piped = pipe(wakePipe);
+        if (piped == 0) {
+            fcntl(wakePipe[0], F_SETFD, FD_CLOEXEC);
+            fcntl(wakePipe[1], F_SETFD, FD_CLOEXEC);
+        }
+#endif
+        if (piped != 0) {
+            error = lastError();
+            return false;
+        }
+#endif
+        channel = logger->registerChannel(name);
+        worker = std::thread([this]() { run(); });
+        return true;
+    }
+
+    void run() {
+        std::string text;
+        std::vector<uint32_t> lineEnds;
+        std::vector<uint8_t> levels;
+        while (waitReadable()) {
+            //  ,    ,    
+            size_t received = 0;
+            do {
+                received = receiveBatch(text, lineEnds, levels);
+            } while (received == BatchMessages && lineEnds.size() < MaxBatchLines);
+            if (!lineEnds.empty()) {
+                logger->logBatch(channel, std::move(text), std::move(lineEnds), std::move(levels));
+                text.clear();
+                lineEnds.clear();
+                levels.clear();
+            }
+        }
+    }
+
+    //  ; false -  
+    bool waitReadable() {
+        while (!stopping.load()) {
+#ifdef _WIN32
+            //         200 
+            WSAPOLLFD entry = {};
+            entry.fd = socket;
+            entry.events = POLLRDNORM;
+            int ready = WSAPoll(&entry, 1, 200);
+            if (ready > 0) {
+                return !stopping.load();
+            }
+            if (ready < 0) {
+                return false;
+            }
+#else
+            struct pollfd fds[2] = {};
+            fds[0].fd = socket;
+            fds[0].events = POLLIN;
+            fds[1].fd = wakePipe[0];
+            fds[1].events = POLLIN;
+            int ready = poll(fds, 2, -1);
+            if (ready < 0 && errno != EINTR) {
+                return false;
+            }
+            if (ready > 0 && (fds[0].revents & POLLIN)) {
+                return !stopping.load();
+            }
+#endif
+        }
+        return false;
+    }
+
+    //    (  BatchMessages)     
+    size_t receiveBatch(std::string& text, std::vector<uint32_t>& lineEnds, std::vector<uint8_t>& levels) {
+        size_t lengths[BatchMessages];
+        size_t count = 0;
+#if defined(__linux__)
+        struct mmsghdr messages[BatchMessages];
+        struct iovec vectors[BatchMessages];
+        for (size_t i = 0; i < BatchMessages; ++i) {
+            vectors[i].iov_base = &buffers[i * MessageBytes];
+            vectors[i].iov_len = MessageBytes;
+            messages[i] = mmsghdr();
+            messages[i].msg_hdr.msg_iov = &vectors[i];
+            messages[i].msg_hdr.msg_iovlen = 1;
+        }
+        int result = recvmmsg(socket, messages, BatchMessages, MSG_DONTWAIT, nullptr);
+        if (result <= 0) {
+            return 0;
+        }
+        count = static_cast<size_t>(result);
+        for (size_t i = 0; i < count; ++i) {
+            lengths[i] = std::min<size_t>(messages[i].msg_len, MessageBytes);
+        }
+#else
+        //  recvmmsg -     ,    
+        for (; count < BatchMessages; ++count) {
+            int result = recv(socket, &buffers[count * MessageBytes], static_cast<int>(MessageBytes), 0);
+            if (result < 0) {
+#ifdef _WIN32
+                // WSAEMSGSIZE -     
+                if (WSAGetLastError() == WSAEMSGSIZE) {
+                    lengths[count] = MessageBytes;
+                    continue;
+                }
+#endif
+                break;
+            }
+            lengths[count] = static_cast<size_t>(result);
+        }
+#endif
+        for (size_t i = 0; i < count; ++i) {
+            appendMessage(&buffers[i * MessageBytes], lengths[i], text, lineEnds, levels);
+        }
+        return count;
+    }
+
+    //   "<PRI>"     
+    static void appendMessage(const char* data, size_t length, std::string& text, std::vector<uint32_t>& lineEnds,
+        std::vector<uint8_t>& levels) {
+        LogLevel level = LogLevel::Info;
+        if (length > 2 && data[0] == '<') {
+            size_t close = 1;
+            int priority = 0;
+            while (close < length && close < 5 && data[close] >= '0' && data[close] <= '9') {
+                priority = priority * 10 + (data[close] - '0');
+                ++close;
+            }
+            if (close > 1 && close < length && data[close] == '>') {
+                level = severityLevel(priority & 7);
+                data += close + 1;
+                length -= close + 1;
+            }
+        }
+        while (length > 0 && (data[length - 1] == '\n' || data[length - 1] == '\r' || data[length - 1] == '\0')) {
+            --length;
+        }
+        text.append(data, length);
+        lineEnds.push_back(static_cast<uint32_t>(text.size()));
+        text.push_back('\n');
+        levels.push_back(static_cast<uint8_t>(level));
+    }
+
+    //  syslog (0 - emerg ... 7 - debug)   
+    static LogLevel severityLevel(int severity) {
+        if (severity <= 3) {
+            return LogLevel::Error;
+        }
+        if (severity == 4) {
+            return LogLevel::Warning;
+        }
+        return severity == 7 ? LogLevel::Debug : LogLevel::Info;
+    }
+};
\ No newline at end of file
@@ -0,0 +1,544 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <chrono>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "Logger.h"
+#include "LineBatcher.h"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/stat.h>
+#ifdef __linux__
+#include <sys/inotify.h>
+#endif
+#endif
+
+//     ( tail -F)   .
+//           (inotify  Linux,
+// FindFirstChangeNotification  Windows),     
+//      (reserve/commit/finish/discard,   LineBatcher).
+//     ,     () 
+//      .  FileTail    tail
+class FileFollower {
+public:
+    static const size_t ReadBlock = 1 << 20;        //   
+    static const size_t CheckBytes = 64;            //     
+    static const int CheckInterval = 1000;          //     , 
+
+    enum class Wait {
+        Changed,        //   :   readAppended
+        Timeout,        //   ,  
+        Stopped         //  requestStop()   
+    };
+
+private:
+    //  :       
+    struct FileIdentity {
+        uint64_t device;
+        uint64_t index;
+
+        bool operator==(const FileIdentity& other) const {
+            return device == other.device && index == other.index;
+        }
+    };
+
+    std::string path;
+    std::string directory;
+    std::string fileName;
+
+    std::atomic<bool> stopping;
+#ifdef _WIN32
+    HANDLE file;
+    HANDLE stopEvent;
+    HANDLE changes;
+#else
+    int file;
+    int wakePipe[2];
+    int notify;
+#endif
+    FileIdentity identity;
+    uint64_t offset;            //      
+    std::string lastBytes;      //    (  )
+    std::chrono::steady_clock::time_point lastCheck;
+
+public:
+    explicit FileFollower(const std::string& path) :
+        path(path),
+        stopping(false),
+#ifdef _WIN32
+        file(INVALID_HANDLE_VALUE),
+        stopEvent(NULL),
+        changes(INVALID_HANDLE_VALUE),
+#else
+        file(-1),
+        notify(-1),
+#endif
+        identity(),
+        offset(0),
+        lastCheck(std::chrono::steady_clock::now()) {
+
+        size_t slash = path.find_last_of("/\\");
+        directory = slash == std::string::npos ? "." : path.substr(0, slash + 1);
+        fileName = baseName(path);
+#ifndef _WIN32
+        wakePipe[0] = wakePipe[1] = -1;
+#endif
+    }
+
+    ~FileFollower() {
+        closeFile();
+#ifdef _WIN32
+        if (changes != INVALID_HANDLE_VALUE) {
+            FindCloseChangeNotification(changes);
+        }
+        if (stopEvent) {
+            CloseHandle(stopEvent);
+        }
+#else
+        if (notify >= 0) {
+            close(notify);
+        }
+        for (int fd : wakePipe) {
+            if (fd >= 0) {
+                close(fd);
+            }
+        }
+#endif
+    }
+
+    FileFollower(const FileFollower&) = delete;
+    FileFollower& operator=(const FileFollower&) = delete;
+
+    static std::string baseName(const std::string& path) {
+        size_t slash = path.find_last_of("/\\");
+        return slash == std::string::npos ? path : path.substr(slash + 1);
+    }
+
+    const std::string& getPath() const {
+        return path;
+    }
+
+    //     
+    bool watch(std::string& error) {
+#ifdef _WIN32
+        stopEvent = CreateEventA(NULL, TRUE, FALSE, NULL);
+        changes = FindFirstChangeNotificationA(directory.c_str(), FALSE,
+            FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_SIZE | FILE_NOTIFY_CHANGE_LAST_WRITE);
+        if (!stopEvent || changes == INVALID_HANDLE_VALUE) {
+            error = u8"     " + directory;
+            return false;
+        }
+#else
+#ifdef __linux__
+        int piped = pipe2(wakePipe, O_CLOEXEC);
+#else
+        int piped = pipe(wakePipe);
+        if (piped == 0) {
+            fcntl(wakePipe[0], F_SETFD, FD_CLOEXEC);
+            fcntl(wakePipe[1], F_SETFD, FD_CLOEXEC);
+        }
+#endif
+        if (piped != 0) {
+            error = std::strerror(errno);
+            return false;
+        }
+#ifdef __linux__
+        notify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (notify < 0 || inotify_add_watch(notify, directory.c_str(),
+            IN_MODIFY | IN_ATTRIB | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_CLOSE_WRITE) < 0) {
+            error = directory + ": " + std::strerror(errno);
+            return false;
+        }
+#endif
+#endif
+        return true;
+    }
+
+    //  ,    ,         bytes 
+    void skipToTail(uint64_t bytes) {
+        if (!openFile()) {
+            return;
+        }
+        uint64_t size = fileSize();
+        if (size > bytes) {
+            offset = size - bytes;
+            skipPartialLine();
+        }
+    }
+
+    //       timeout  (-1 -  ).
+    //  ,    -  (,  ),
+    //      Timeout
+    Wait waitForChanges(int timeout) {
+#ifdef __linux__
+        bool periodic = false;
+        int wait = timeout;
+#else
+        //  inotify (  Windows - - ,  NTFS   
+        //     )      CheckInterval
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - lastCheck).count();
+        int untilCheck = elapsed >= CheckInterval ? 0 : CheckInterval - static_cast<int>(elapsed);
+        bool periodic = timeout < 0 || untilCheck <= timeout;
+        int wait = periodic ? untilCheck : timeout;
+#endif
+#ifdef _WIN32
+        HANDLE handles[2] = { stopEvent, changes };
+        DWORD result = WaitForMultipleObjects(2, handles, FALSE, static_cast<DWORD>(wait));
+        if (stopping.load() || result == WAIT_FAILED) {
+            return Wait::Stopped;
+        }
+        if (result == WAIT_OBJECT_0 + 1) {
+            FindNextChangeNotification(changes);
+            return Wait::Changed;
+        }
+        return periodic ? Wait::Changed : Wait::Timeout;
+#else
+        struct pollfd fds[2] = {};
+        fds[0].fd = wakePipe[0];
+        fds[0].events = POLLIN;
+        fds[1].fd = notify;
+        fds[1].events = POLLIN;
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(wait);
+        while (!stopping.load()) {
+            int remaining = -1;
+            if (wait >= 0) {
+                auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    deadline - std::chrono::steady_clock::now()).count();
+                remaining = left > 0 ? static_cast<int>(left) : 0;
+            }
+            int ready = poll(fds, notify >= 0 ? 2 : 1, remaining);
+            if (ready < 0 && errno != EINTR) {
+                return Wait::Stopped;
+            }
+            if (ready == 0) {
+                return periodic ? Wait::Changed : Wait::Timeout;
+            }
+            if (ready > 0 && (fds[1].revents & POLLIN) && drainNotifications()) {
+                return Wait::Changed;
+            }
+        }
+        return Wait::Stopped;
+#endif
+    }
+
+    //   (  ): waitForChanges  Stopped
+    void requestStop() {
+        stopping.store(true);
+#ifdef _WIN32
+        if (stopEvent) {
+            SetEvent(stopEvent);
+        }
+#else
+        char wake = 0;
+        if (wakePipe[1] >= 0 && write(wakePipe[1], &wake, 1) < 0) {
+            //         
+        }
+#endif
+    }
+
+    //   sink ,     ,     .
+    //  ,       notice(LogLevel, const std::string&)
+    template <typename Sink, typename Notice>
+    void readAppended(Sink& sink, Notice&& notice) {
+        lastCheck = std::chrono::steady_clock::now();
+        if (!isOpen()) {
+            if (!openFile()) {
+                return;
+            }
+            notice(LogLevel::Info, u8" : " + path);
+        }
+
+        FileIdentity current;
+        if (identityAtPath(current) && !(current == identity)) {
+            //  :        
+            readRange(sink, fileSize());
+            sink.finish();
+            closeFile();
+            if (!openFile()) {
+                return;
+            }
+            notice(LogLevel::Warning, u8" ,   : " + path);
+        }
+
+        // ,       ,  
+        //    offset
+        uint64_t size = fileSize();
+        if (size < offset || !unchangedBeforeOffset()) {
+            notice(LogLevel::Warning, u8" ,   : " + path);
+            offset = 0;
+            sink.discard();
+            lastBytes.clear();
+        }
+        readRange(sink, size);
+    }
+
+private:
+#ifndef _WIN32
+    //    inotify; true - -    
+    bool drainNotifications() {
+        bool relevant = false;
+#ifdef __linux__
+        alignas(struct inotify_event) char events[4096];
+        ssize_t length;
+        while ((length = read(notify, events, sizeof(events))) > 0) {
+            for (ssize_t position = 0; position < length;) {
+                const struct inotify_event* event = reinterpret_cast<const struct inotify_event*>(events + position);
+                if ((event->mask & IN_Q_OVERFLOW) || (event->len > 0 && fileName == event->name)) {
+                    relevant = true;
+                }
+                position += sizeof(struct inotify_event) + event->len;
+            }
+        }
+#endif
+        return relevant;
+    }
+#endif
+
+    //  [offset, end)  sink
+    template <typename Sink>
+    void readRange(Sink& sink, uint64_t end) {
+        while (offset < end && !stopping.load()) {
+            size_t wanted = static_cast<size_t>(std::min<uint64_t>(end - offset, ReadBlock));
+            char* target = sink.reserve(wanted);
+            size_t received = readAt(offset, target, wanted);
+            size_t keep = std::min(received, CheckBytes);
+            lastBytes.append(target + received - keep, keep);
+            if (lastBytes.size() > CheckBytes) {
+                lastBytes.erase(0, lastBytes.size() - CheckBytes);
+            }
+            sink.commit(received);
+            if (received == 0) {
+                return;
+            }
+            offset += received;
+        }
+    }
+
+    bool unchangedBeforeOffset() const {
+        if (lastBytes.empty()) {
+            return true;
+        }
+        char check[CheckBytes];
+        size_t received = readAt(offset - lastBytes.size(), check, lastBytes.size());
+        return received == lastBytes.size() && std::memcmp(check, lastBytes.data(), received) == 0;
+    }
+
+    //       offset
+    void skipPartialLine() {
+        std::vector<char> buffer(64 * 1024);
+        while (true) {
+            size_t received = readAt(offset, buffer.data(), buffer.size());
+            if (received == 0) {
+                return;
+            }
+            const char* newline = static_cast<const char*>(std::memchr(buffer.data(), '\n', received));
+            if (newline) {
+                offset += static_cast<uint64_t>(newline - buffer.data()) + 1;
+                return;
+            }
+            offset += received;
+        }
+    }
+
+    //   (    )
+    bool isOpen() const {
+#ifdef _WIN32
+        return file != INVALID_HANDLE_VALUE;
+#else
+        return file >= 0;
+#endif
+    }
+
+    bool openFile() {
+        offset = 0;
+        lastBytes.clear();
+#ifdef _WIN32
+        //      ,     
+        file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+            NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+        if (file == INVALID_HANDLE_VALUE) {
+            return false;
+        }
+        BY_HANDLE_FILE_INFORMATION info;
+        if (!GetFileInformationByHandle(file, &info)) {
+            closeFile();
+            return false;
+        }
+        identity.device = info.dwVolumeSerialNumber;
+        identity.index = (static_cast<uint64_t>(info.nFileIndexHigh) << 32) | info.nFileIndexLow;
+#else
+        file = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (file < 0) {
+            return false;
+        }
+        struct stat info;
+        if (fstat(file, &info) != 0) {
+            closeFile();
+            return false;
+        }
+        identity.device = static_cast<uint64_t>(info.st_dev);
+        identity.index = static_cast<uint64_t>(info.st_ino);
+#endif
+        return true;
+    }
+
+    void closeFile() {
+#ifdef _WIN32
+        if (file != INVALID_HANDLE_VALUE) {
+            CloseHandle(file);
+            file = INVALID_HANDLE_VALUE;
+        }
+#else
+        if (file >= 0) {
+            close(file);
+            file = -1;
+        }
+#endif
+    }
+
+    //  ,      path
+    bool identityAtPath(FileIdentity& result) const {
+#ifdef _WIN32
+        HANDLE probe = CreateFileA(path.c_str(), 0, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+            NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+        if (probe == INVALID_HANDLE_VALUE) {
+            return false;
+        }
+        BY_HANDLE_FILE_INFORMATION info;
+        BOOL ok = GetFileInformationByHandle(probe, &info);
+        CloseHandle(probe);
+        if (!ok) {
+            return false;
+        }
+        result.device = info.dwVolumeSerialNumber;
+        result.index = (static_cast<uint64_t>(info.nFileIndexHigh) << 32) | info.nFileIndexLow;
+#else
+        struct stat info;
+        if (stat(path.c_str(), &info) != 0) {
+            return false;
+        }
+        result.device = static_cast<uint64_t>(info.st_dev);
+        result.index = static_cast<uint64_t>(info.st_ino);
+#endif
+        return true;
+    }
+
+    uint64_t fileSize() const {
+#ifdef _WIN32
+        LARGE_INTEGER size;
+        return GetFileSizeEx(file, &size) ? static_cast<uint64_t>(size.QuadPart) : 0;
+#else
+        struct stat info;
+        return fstat(file, &info) == 0 ? static_cast<uint64_t>(info.st_size) : 0;
+#endif
+    }
+
+    size_t readAt(uint64_t position, char* data, size_t length) const {
+#ifdef _WIN32
+        OVERLAPPED overlapped = {};
+        overlapped.Offset = static_cast<DWORD>(position & 0xFFFFFFFF);
+        overlapped.OffsetHigh = static_cast<DWORD>(position >> 32);
+        DWORD received = 0;
+        if (!ReadFile(file, data, static_cast<DWORD>(length), &received, &overlapped)) {
+            return 0;
+        }
+        return received;
+#else
+        ssize_t received = pread(file, data, length, static_cast<off_t>(position));
+        return received > 0 ? static_cast<size_t>(received) : 0;
+#endif
+    }
+};
+
+//      ( tail -F)   : FileFollower
+//        ,   
+class FileTail {
+public:
+    static const size_t InitialBytes = 64 * 1024;   //      
+
+private:
+    std::shared_ptr<Logger> logger;
+    uint16_t channel;           //    start()
+    FileFollower follower;
+    std::thread worker;
+    LineBatcher batcher;
+
+public:
+    FileTail(std::shared_ptr<Logger> logger, const std::string& path) :
+        logger(logger),
+        channel(Logger::ConsoleChannel),
+        follower(path),
+        batcher(logger, channel) {}
+
+    ~FileTail() {
+        stop();
+    }
+
+    FileTail(const FileTail&) = delete;
+    FileTail& operator=(const FileTail&) = delete;
+
+    //        .
+    //     :  ,   
+    bool start(std::string& error) {
+        if (!follower.watch(error)) {
+            return false;
+        }
+        //     ,    ,
+        //       
+        channel = logger->registerChannel(FileFollower::baseName(follower.getPath()));
+        batcher = LineBatcher(logger, channel);
+        //  tail,    
+        follower.skipToTail(InitialBytes);
+        worker = std::thread([this]() { run(); });
+        return true;
+    }
+
+    //   
+    void stop() {
+        if (!worker.joinable()) {
+            return;
+        }
+        follower.requestStop();
+        worker.join();
+    }
+
+    const std::string& getPath() const {
+        return follower.getPath();
+    }
+
+private:
+    void run() {
+        auto notice = [this](LogLevel level, const std::string& message) {
+            logger->log(level, channel, message.data(), message.size());
+        };
+        follower.readAppended(batcher, notice);
+        FileFollower::Wait result;
+        while ((result = follower.waitForChanges(-1)) != FileFollower::Wait::Stopped) {
+            if (result == FileFollower::Wait::Changed) {
+                follower.readAppended(batcher, notice);
+            }
+        }
+        batcher.finish();
+    }
+};
\ No newline at end of file
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "Logger.h"
+
+//        Logger::logBatch().
+//       (reserve/commit),  
+//   ,        .
+//        
+class LineBatcher {
+public:
+    static const size_t MaxLineLength = 1 << 20;    //     
+
+private:
+    std::shared_ptr<Logger> logger;
+    uint16_t channel;
+    LogLevel level;
+    bool mayDrop;                       // false -       
+    std::string text;                   //     
+    std::vector<uint32_t> lineEnds;
+    size_t scanned;                     //  text     
+    size_t reserved;                    //  text   reserve()
+
+public:
+    LineBatcher(std::shared_ptr<Logger> logger, uint16_t channel, LogLevel level = LogLevel::Info,
+        bool mayDrop = true) :
+        logger(logger),
+        channel(channel),
+        level(level),
+        mayDrop(mayDrop),
+        scanned(0),
+        reserved(0) {}
+
+    //    length    
+    char* reserve(size_t length) {
+        reserved = text.size();
+        text.resize(reserved + length);
+        return &text[reserved];
+    }
+
+    //  length ,   reserve(),    
+    void commit(size_t length) {
+        text.resize(reserved + length);
+        const char* data = text.data();
+        size_t lineStart = lineEnds.empty() ? 0 : lineEnds.back() + 1;
+        while (scanned < text.size()) {
+            const void* newline = std::memchr(data + scanned, '\n', text.size() - scanned);
+            if (!newline) {
+                scanned = text.size();
+                break;
+            }
+            scanned = static_cast<size_t>(static_cast<const char*>(newline) - data);
+            lineEnds.push_back(static_cast<uint32_t>(scanned));
+            lineStart = ++scanned;
+        }
+        //    ,      
+        if (text.size() - lineStart >= MaxLineLength) {
+            text.push_back('\n');
+            lineEnds.push_back(static_cast<uint32_t>(text.size() - 1));
+            scanned = text.size();
+        }
+        send();
+    }
+
+    //    ( )
+    void finish() {
+        size_t lineStart = lineEnds.empty() ? 0 : lineEnds.back() + 1;
+        if (text.size() > lineStart) {
+            text.push_back('\n');
+            lineEnds.push_back(static_cast<uint32_t>(text.size() - 1));
+        }
+        send();
+    }
+
+    //    (  )
+    void discard() {
+        size_t lineStart = lineEnds.empty() ? 0 : lineEnds.back() + 1;
+        text.resize(lineStart);
+        scanned = text.size();
+    }
+
+private:
+    void send() {
+        if (lineEnds.empty()) {
+            return;
+        }
+        size_t complete = lineEnds.back() + 1;
+        if (complete * 4 < text.capacity()) {
+            //   ,       
+            std::string batch(text, 0, complete);
+            text.erase(0, complete);
+            logger->logBatch(level, channel, std::move(batch), std::move(lineEnds), mayDrop);
+        }
+        else {
+            std::string rest(text, complete);
+            text.resize(complete);
+            logger->logBatch(level, channel, std::move(text), std::move(lineEnds), mayDrop);
+            text = std::move(rest);
+        }
+        lineEnds.clear();
+        scanned = text.size();
+    }
+};
\ No newline at end of file
@@ -0,0 +1,1222 @@
+#pragma once
+
+#include <map>
+#include <deque>
+#include <vector>
+#include <string>
+#include <memory>
+#include <cstring>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <algorithm>
+
+#include "SegmentFile.h"
+#include "ChunkPacker.h"
+
+//  :           
+// ( ).        
+//      ,        
+struct LogLine {
+    int64_t timestamp;      //    system_clock
+    uint8_t level;
+    uint16_t source;
+    const char* begin;
+    const char* end;
+
+    size_t size() const { return static_cast<size_t>(end - begin); }
+};
+
+//     ( escape- ANSI)
+struct ColorSpan {
+    uint32_t offset;        //     
+    uint32_t length;
+    uint32_t color;         // RGBA    IM_COL32
+};
+
+//  :             
+// (   - timestamp  )
+struct LineRepeat {
+    uint32_t count;
+    int64_t lastTimestamp;
+};
+
+//   .
+//       - (),   
+//       .   -  memcpy,
+//      .
+//      (, , ,  ),
+//          .
+//     :   maxLines   
+// ,    .    
+// ,      .
+//   .    ,   
+// KeepRawChunks     (LzCodec)    ;
+//     MaxUnpackedChunks  .
+//        ,     
+//      ( -   )    
+//   ;     MaxMappedChunks
+//   .
+//     :      ,  
+//  (,          ),
+//     .      -
+//          .
+//           
+//      
+class LogStore {
+public:
+    static const size_t LinesPerChunk = 4096;
+    static const int AnySource = -1;
+    static const size_t MaxMappedChunks = 64;
+    static const size_t MaxUnpackedChunks = 8;
+    static const size_t KeepRawChunks = 2;
+
+    //     :       
+    struct ChunkColumns {
+        uint64_t firstId;
+        size_t lines;
+        const int64_t* timestamps;
+        const uint32_t* offsets;
+        const uint16_t* sources;
+        const uint8_t* levels;
+        const char* data;
+        size_t used;
+
+        const char* lineBegin(size_t pos) const { return data + offsets[pos]; }
+        const char* lineEnd(size_t pos) const { return data + (pos + 1 < lines ? offsets[pos + 1] : used); }
+    };
+
+private:
+    struct Chunk {
+        uint64_t firstId = 0;
+        std::unique_ptr<char[]> data;
+        size_t used = 0;
+        size_t capacity = 0;
+        std::vector<uint32_t> offsets;  //   ;  -    used
+        std::vector<int64_t> timestamps;
+        std::vector<uint8_t> levels;
+        std::vector<uint16_t> sources;
+
+        //     (    )
+        std::shared_ptr<SegmentFile> file;
+        uint64_t fileOffset = 0;
+        size_t fileBytes = 0;
+        size_t lineCount = 0;
+        mutable MappedRegion mapping;
+        mutable uint64_t lastUse = 0;
+
+        //   (  ,    ,   )
+        std::unique_ptr<char[]> packedData;
+        size_t packedBytes = 0;
+        size_t segmentBytes = 0;        //    ; 0 -   
+        bool packRequested = false;
+
+        //        (nullptr - )
+        std::shared_ptr<const std::vector<uint16_t>> sourceMap;
+        mutable std::unique_ptr<uint16_t[]> remappedSources;
+
+        bool spilled() const { return file != nullptr; }
+        bool compressed() const { return segmentBytes > 0; }
+        bool raw() const { return !spilled() && !compressed(); }
+        size_t lines() const { return raw() ? offsets.size() : lineCount; }
+
+        // ,    
+        size_t residentBytes() const {
+            return capacity + offsets.capacity() * sizeof(uint32_t) +
+                timestamps.capacity() * sizeof(int64_t) +
+                levels.capacity() * sizeof(uint8_t) +
+                sources.capacity() * sizeof(uint16_t) +
+                (packedData ? packedBytes : 0) +
+                (remappedSources ? lineCount * sizeof(uint16_t) : 0);
+        }
+
+        //  ,    
+        void grow(size_t newCapacity) {
+            std::unique_ptr<char[]> newData(new char[newCapacity]);
+            if (used > 0) {
+                memcpy(newData.get(), data.get(), used);
+            }
+            data = std::move(newData);
+            capacity = newCapacity;
+        }
+
+        //    ,    
+        char* reserve(int64_t timestamp, uint8_t level, uint16_t source, size_t length) {
+            if (used + length > capacity) {
+                size_t newCapacity = capacity > 0 ? capacity * 2 : InitialChunkBytes;
+                while (newCapacity < used + length) {
+                    newCapacity *= 2;
+                }
+                grow(newCapacity);
+            }
+            offsets.push_back(static_cast<uint32_t>(used));
+            timestamps.push_back(timestamp);
+            levels.push_back(level);
+            sources.push_back(source);
+            char* out = data.get() + used;
+            used += length;
+            return out;
+        }
+
+        //    .     
+        // ,         
+        void reset(uint64_t id, size_t expectedBytes) {
+            firstId = id;
+            used = 0;
+            packedData.reset();
+            packedBytes = 0;
+            segmentBytes = 0;
+            packRequested = false;
+            sourceMap.reset();
+            remappedSources.reset();
+            offsets.clear();
+            offsets.reserve(LinesPerChunk);
+            timestamps.clear();
+            timestamps.reserve(LinesPerChunk);
+            levels.clear();
+            levels.reserve(LinesPerChunk);
+            sources.clear();
+            sources.reserve(LinesPerChunk);
+            if (expectedBytes > capacity) {
+                grow(expectedBytes);
+            }
+        }
+
+        //        
+        void giveBuffers(Chunk& target) {
+            target.data = std::move(data);
+            target.capacity = capacity;
+            target.offsets.swap(offsets);
+            target.timestamps.swap(timestamps);
+            target.levels.swap(levels);
+            target.sources.swap(sources);
+            capacity = 0;
+            std::vector<uint32_t>().swap(offsets);
+            std::vector<int64_t>().swap(timestamps);
+            std::vector<uint8_t>().swap(levels);
+            std::vector<uint16_t>().swap(sources);
+        }
+    };
+
+    static const size_t InitialChunkBytes = 256 * 1024;
+    static const size_t DefaultMemoryBudget = 256 * 1024 * 1024;
+
+    std::deque<std::unique_ptr<Chunk>> chunks;
+    std::unique_ptr<Chunk> spare;   //     
+    size_t maxLines;
+    uint64_t first;                 //    
+    uint64_t next;                  //    
+
+    size_t memoryBudget;            //      
+    size_t spilledChunks;           //         
+    std::shared_ptr<SegmentFile> spillFile;
+    bool spillFailed;
+
+    mutable std::vector<const Chunk*> mappedChunks;
+    mutable uint64_t useCounter;
+
+    //    
+    struct UnpackedChunk {
+        const Chunk* chunk;
+        std::unique_ptr<char[]> segment;
+    };
+
+    mutable std::vector<UnpackedChunk> unpackedChunks;
+    std::unique_ptr<ChunkPacker> packer;    //    
+
+    std::map<uint64_t, LineRepeat> repeats;    //   ,  
+
+    //   :      ,
+    //       colorSpans
+    struct LineSpans {
+        uint64_t id;
+        uint64_t firstSpan;     //      spansBase
+        uint32_t count;
+    };
+
+    std::vector<LineSpans> lineSpans;
+    size_t lineSpansStart;      //        
+    std::vector<ColorSpan> colorSpans;
+    uint64_t spansBase;         //   colorSpans[0]
+
+    //        
+    struct SessionEntry {
+        uint64_t fileOffset;
+        uint64_t fileBytes;
+        int64_t firstTimestamp;
+        int64_t lastTimestamp;
+        uint32_t lineCount;
+        uint32_t usedBytes;         //   
+        uint32_t segmentBytes;      //    ; 0 -   
+        uint32_t reserved;
+    };
+
+    //    
+    struct SessionTrailer {
+        char magic[8];
+        uint32_t version;
+        uint32_t entryCount;
+        uint64_t indexOffset;       //  ;       
+        uint32_t channelCount;
+        uint32_t channelBytes;      //  :  (uint16_t)   
+    };
+
+    static const uint32_t SessionVersion = 1;
+    static const uint64_t NoPartialChunk = UINT64_MAX;
+
+    //  ,        
+    struct Session {
+        std::shared_ptr<SegmentFile> file;
+        std::vector<SessionEntry> entries;
+        std::vector<std::string> channels;          //     
+        uint64_t savedEnd = 0;                      //        
+        uint64_t partialId = NoPartialChunk;        //    
+        uint64_t tail = 0;                          //     
+    };
+
+    Session session;
+
+public:
+    class const_iterator {
+    private:
+        const LogStore* store;
+        uint64_t id;
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = LogLine;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const LogLine*;
+        using reference = LogLine;
+
+        const_iterator(const LogStore* store, uint64_t id) : store(store), id(id) {}
+
+        LogLine operator*() const { return store->line(id); }
+        const_iterator& operator++() { ++id; return *this; }
+        const_iterator operator++(int) { const_iterator tmp = *this; ++id; return tmp; }
+        bool operator==(const const_iterator& other) const { return id == other.id; }
+        bool operator!=(const const_iterator& other) const { return id != other.id; }
+    };
+
+    LogStore(size_t maxLines, size_t memoryBudget = DefaultMemoryBudget) :
+        maxLines(maxLines > 0 ? maxLines : 1),
+        first(0),
+        next(0),
+        memoryBudget(memoryBudget),
+        spilledChunks(0),
+        spillFailed(false),
+        useCounter(0),
+        lineSpansStart(0),
+        spansBase(0) {}
+
+    //     ,     
+    uint64_t append(int64_t timestamp, uint8_t level, uint16_t source,
+        const char* const* parts, const size_t* lengths, size_t partCount) {
+        size_t total = 0;
+        for (size_t i = 0; i < partCount; ++i) {
+            total += lengths[i];
+        }
+
+        char* out = allocateLine(timestamp, level, source, total);
+        for (size_t i = 0; i < partCount; ++i) {
+            memcpy(out, parts[i], lengths[i]);
+            out += lengths[i];
+        }
+        return commitLine();
+    }
+
+    uint64_t append(int64_t timestamp, uint8_t level, uint16_t source, const char* text, size_t length) {
+        return append(timestamp, level, source, &text, &length, 1);
+    }
+
+    //   .   
+    void clear() {
+        mappedChunks.clear();
+        unpackedChunks.clear();
+        if (packer) {
+            packer->cancel();
+        }
+        while (!chunks.empty()) {
+            recycle(std::move(chunks.front()));
+            chunks.pop_front();
+        }
+        spilledChunks = 0;
+        if (spillFile) {
+            spillFile->truncate();
+        }
+        repeats.clear();
+        lineSpans.clear();
+        lineSpansStart = 0;
+        colorSpans.clear();
+        spansBase = 0;
+        first = next;
+        session = Session();
+    }
+
+    // ,       
+    bool contains(uint64_t id) const {
+        return id >= first && id < next;
+    }
+
+    //    (  contains)
+    LogLine line(uint64_t id) const {
+        ChunkColumns columns = columnsFor(chunkFor(id));
+        size_t pos = static_cast<size_t>(id - columns.firstId);
+        LogLine result = { columns.timestamps[pos], columns.levels[pos], columns.sources[pos],
+            columns.lineBegin(pos), columns.lineEnd(pos) };
+        return result;
+    }
+
+    //      id     
+    void addRepeat(uint64_t id, int64_t timestamp) {
+        LineRepeat& repeat = repeats[id];
+        if (repeat.count == 0) {
+            repeat.count = 1;
+        }
+        if (repeat.count < UINT32_MAX) {
+            ++repeat.count;
+        }
+        repeat.lastTimestamp = timestamp;
+    }
+
+    //   id (nullptr -   )
+    const LineRepeat* repeatOf(uint64_t id) const {
+        auto it = repeats.find(id);
+        return it != repeats.end() ? &it->second : nullptr;
+    }
+
+    //        id
+    void setSpans(uint64_t id, const ColorSpan* spans, size_t count) {
+        LineSpans entry = { id, spansBase + colorSpans.size(), static_cast<uint32_t>(count) };
+        lineSpans.push_back(entry);
+        colorSpans.insert(colorSpans.end(), spans, spans + count);
+    }
+
+    //    id (0 -   ).  
+    //    
+    size_t spansOf(uint64_t id, const ColorSpan*& spans) const {
+        if (lineSpansStart == lineSpans.size() || id < lineSpans[lineSpansStart].id || id > lineSpans.back().id) {
+            return 0;
+        }
+        auto it = std::lower_bound(lineSpans.begin() + lineSpansStart, lineSpans.end(), id,
+            [](const LineSpans& entry, uint64_t value) { return entry.id < value; });
+        if (it == lineSpans.end() || it->id != id) {
+            return 0;
+        }
+        spans = colorSpans.data() + (it->firstSpan - spansBase);
+        return it->count;
+    }
+
+    //  callback(id)    [from, to)     minLevel
+    //   source (AnySource - ).    
+    template <typename Callback>
+    void scan(uint64_t from, uint64_t to, uint8_t minLevel, int source, Callback callback) const {
+        scanChunks(from, to, [&](const ChunkColumns& columns, size_t pos, size_t end) {
+            for (; pos < end; ++pos) {
+                if (columns.levels[pos] >= minLevel && (source == AnySource || columns.sources[pos] == source)) {
+                    callback(columns.firstId + pos);
+                }
+            }
+            return true;
+            });
+    }
+
+    //  callback(columns, begin, end)   ,   [from, to),
+    //  [begin, end) -    .    
+    //    .  ,  callback  false
+    template <typename Callback>
+    void scanChunks(uint64_t from, uint64_t to, Callback callback) const {
+        if (from < first) {
+            from = first;
+        }
+        if (to > next) {
+            to = next;
+        }
+        while (from < to) {
+            ChunkColumns columns = columnsFor(chunkFor(from));
+            size_t pos = static_cast<size_t>(from - columns.firstId);
+            size_t end = static_cast<size_t>(std::min<uint64_t>(to - columns.firstId, columns.lines));
+            if (!callback(columns, pos, end)) {
+                return;
+            }
+            from = columns.firstId + end;
+        }
+    }
+
+    uint64_t firstId() const { return first; }
+    uint64_t endId() const { return next; }
+
+    size_t size() const { return static_cast<size_t>(next - first); }
+    size_t capacity() const { return maxLines; }
+    bool empty() const { return first == next; }
+
+    //       (0 -  )
+    void setMemoryBudget(size_t bytes) {
+        memoryBudget = bytes;
+        enforceBudget();
+    }
+
+    size_t getMemoryBudget() const { return memoryBudget; }
+
+    //  ,    
+    size_t memoryUsage() const {
+        size_t total = 0;
+        for (const auto& chunk : chunks) {
+            total += chunk->residentBytes();
+        }
+        return total + lineSpans.capacity() * sizeof(LineSpans) + colorSpans.capacity() * sizeof(ColorSpan);
+    }
+
+    //  ,       
+    size_t spilledBytes() const {
+        size_t total = 0;
+        for (size_t i = 0; i < spilledChunks; ++i) {
+            total += chunks[i]->fileBytes;
+        }
+        return total;
+    }
+
+    size_t spilledChunkCount() const { return spilledChunks; }
+
+    //     .       (  
+    // ),    . channelNames -    
+    bool saveSession(const std::string& path, const std::vector<std::string>& channelNames, std::string& error) {
+        bool append = session.file && session.file->getPath() == path &&
+            (session.partialId == NoPartialChunk || findChunk(session.partialId) != nullptr);
+        if (!append) {
+            // ,   ,  
+            for (const auto& chunk : chunks) {
+                if (chunk->file && chunk->file->getPath() == path) {
+                    error = u8"   ";
+                    return false;
+                }
+            }
+            session = Session();
+            session.file = SegmentFile::open(path, true, error);
+            if (!session.file) {
+                return false;
+            }
+        }
+        else {
+            if (session.partialId != NoPartialChunk) {
+                session.entries.pop_back();
+            }
+            // Windows      
+            for (size_t i = mappedChunks.size(); i-- > 0; ) {
+                if (mappedChunks[i]->file == session.file) {
+                    mappedChunks[i]->mapping.reset();
+                    mappedChunks.erase(mappedChunks.begin() + i);
+                }
+            }
+            session.file->truncate(session.tail);
+        }
+
+        //      
+        std::vector<uint16_t> toFile(channelNames.size());
+        bool identity = true;
+        for (size_t i = 0; i < channelNames.size(); ++i) {
+            auto it = std::find(session.channels.begin(), session.channels.end(), channelNames[i]);
+            if (it == session.channels.end()) {
+                session.channels.push_back(channelNames[i]);
+                it = session.channels.end() - 1;
+            }
+            toFile[i] = static_cast<uint16_t>(it - session.channels.begin());
+            identity = identity && toFile[i] == i;
+        }
+
+        session.partialId = NoPartialChunk;
+        for (const auto& chunk : chunks) {
+            if (chunk->firstId < session.savedEnd || chunk->lines() == 0) {
+                continue;
+            }
+            SessionEntry entry;
+            if (!writeSessionChunk(*chunk, toFile, identity, entry, error)) {
+                session = Session();
+                return false;
+            }
+            session.entries.push_back(entry);
+            if (chunk->lines() < LinesPerChunk) {
+                session.partialId = chunk->firstId;
+                session.tail = entry.fileOffset;
+            }
+            else {
+                session.savedEnd = chunk->firstId + LinesPerChunk;
+                session.tail = session.file->getSize();
+            }
+        }
+
+        if (!writeSessionIndex(error)) {
+            session = Session();
+            return false;
+        }
+        return true;
+    }
+
+    //       .  
+    // ; registerChannel()     
+    template <typename RegisterChannel>
+    bool loadSession(const std::string& path, RegisterChannel registerChannel, std::string& error) {
+        std::shared_ptr<SegmentFile> file = SegmentFile::open(path, false, error);
+        if (!file) {
+            return false;
+        }
+        SessionTrailer trailer;
+        std::vector<SessionEntry> entries;
+        std::vector<std::string> names;
+        if (!readSessionIndex(*file, trailer, entries, names, error)) {
+            return false;
+        }
+
+        std::vector<uint16_t> toStore(names.size());
+        bool identity = true;
+        for (size_t i = 0; i < names.size(); ++i) {
+            toStore[i] = registerChannel(names[i]);
+            identity = identity && toStore[i] == i;
+        }
+        std::shared_ptr<const std::vector<uint16_t>> sourceMap;
+        if (!identity) {
+            sourceMap = std::make_shared<const std::vector<uint16_t>>(toStore);
+        }
+
+        //    ,   maxLines
+        uint64_t total = 0;
+        for (const SessionEntry& entry : entries) {
+            total += entry.lineCount;
+        }
+        size_t skip = 0;
+        while (skip + 1 < entries.size() && total - entries[skip].lineCount >= maxLines) {
+            total -= entries[skip].lineCount;
+            ++skip;
+        }
+
+        std::deque<std::unique_ptr<Chunk>> loaded;
+        uint64_t id = next;
+        for (size_t i = skip; i < entries.size(); ++i) {
+            const SessionEntry& entry = entries[i];
+            std::unique_ptr<Chunk> chunk(new Chunk());
+            chunk->firstId = id;
+            chunk->file = file;
+            chunk->fileOffset = entry.fileOffset;
+            chunk->fileBytes = static_cast<size_t>(entry.fileBytes);
+            chunk->lineCount = entry.lineCount;
+            chunk->used = entry.usedBytes;
+            chunk->segmentBytes = entry.segmentBytes;
+            chunk->packedBytes = entry.segmentBytes > 0 ? static_cast<size_t>(entry.fileBytes) : 0;
+            chunk->sourceMap = sourceMap;
+            if (entry.lineCount < LinesPerChunk) {
+                //      ,      
+                std::unique_ptr<Chunk> rawChunk = readChunk(*chunk);
+                if (!rawChunk) {
+                    error = u8"     ";
+                    return false;
+                }
+                chunk = std::move(rawChunk);
+            }
+            id += entry.lineCount;
+            loaded.push_back(std::move(chunk));
+        }
+
+        clear();
+        size_t spilled = 0;
+        for (auto& chunk : loaded) {
+            spilled += chunk->spilled() ? 1 : 0;
+            chunks.push_back(std::move(chunk));
+        }
+        spilledChunks = spilled;
+        first = next;
+        next = id;
+        if (next - first > maxLines) {
+            first = next - maxLines;
+        }
+
+        session = Session();
+        session.file = file;
+        session.entries = entries;
+        session.channels = names;
+        session.tail = trailer.indexOffset;
+        session.savedEnd = next;
+        if (!chunks.empty() && chunks.back()->raw()) {
+            session.partialId = chunks.back()->firstId;
+            session.savedEnd = chunks.back()->firstId;
+            session.tail = entries.back().fileOffset;
+        }
+        return true;
+    }
+
+    //    (    )
+    size_t packedChunkCount() const {
+        size_t count = 0;
+        for (const auto& chunk : chunks) {
+            count += chunk->compressed() ? 1 : 0;
+        }
+        return count;
+    }
+
+    //     :     
+    void collectPacked() {
+        if (!packer) {
+            return;
+        }
+        ChunkPacker::Result result;
+        while (packer->poll(result)) {
+            Chunk* chunk = findChunk(result.firstId);
+            //        ,   
+            if (!chunk || !chunk->raw() || result.packedBytes == 0) {
+                continue;
+            }
+            chunk->lineCount = chunk->offsets.size();
+            chunk->packedData = std::move(result.packed);
+            chunk->packedBytes = result.packedBytes;
+            chunk->segmentBytes = result.segmentBytes;
+            releaseBuffers(*chunk);
+        }
+    }
+    size_t mappedChunkCount() const { return mappedChunks.size(); }
+
+    const_iterator begin() const { return const_iterator(this, first); }
+    const_iterator end() const { return const_iterator(this, next); }
+
+private:
+    //  ,  ,  ,  
+    //    
+    const Chunk& chunkFor(uint64_t id) const {
+        size_t index = static_cast<size_t>((id - chunks.front()->firstId) / LinesPerChunk);
+        return *chunks[index];
+    }
+
+    //   ,       
+    ChunkColumns columnsFor(const Chunk& chunk) const {
+        ChunkColumns columns;
+        columns.firstId = chunk.firstId;
+        columns.lines = chunk.lines();
+        columns.used = chunk.used;
+
+        if (chunk.raw()) {
+            columns.timestamps = chunk.timestamps.data();
+            columns.offsets = chunk.offsets.data();
+            columns.sources = chunk.sources.data();
+            columns.levels = chunk.levels.data();
+            columns.data = chunk.data.get();
+            return columns;
+        }
+
+        chunk.lastUse = ++useCounter;
+        const char* base = chunk.compressed() ? unpackSegment(chunk) : mapSegment(chunk);
+        if (!base) {
+            return unavailableColumns(chunk);
+        }
+
+        //    : , , , , 
+        size_t lines = chunk.lineCount;
+        columns.timestamps = reinterpret_cast<const int64_t*>(base);
+        columns.offsets = reinterpret_cast<const uint32_t*>(base + lines * sizeof(int64_t));
+        columns.sources = reinterpret_cast<const uint16_t*>(base + lines * (sizeof(int64_t) + sizeof(uint32_t)));
+        columns.levels = reinterpret_cast<const uint8_t*>(base + lines * (sizeof(int64_t) + sizeof(uint32_t) + sizeof(uint16_t)));
+        columns.data = base + columnBytes(lines);
+
+        //           
+        if (chunk.sourceMap) {
+            if (!chunk.remappedSources) {
+                const std::vector<uint16_t>& map = *chunk.sourceMap;
+                chunk.remappedSources.reset(new uint16_t[lines]);
+                for (size_t i = 0; i < lines; ++i) {
+                    uint16_t source = columns.sources[i];
+                    chunk.remappedSources[i] = source < map.size() ? map[source] : source;
+                }
+            }
+            columns.sources = chunk.remappedSources.get();
+        }
+        return columns;
+    }
+
+    //     
+    const char* mapSegment(const Chunk& chunk) const {
+        if (!chunk.mapping.valid()) {
+            if (mappedChunks.size() >= MaxMappedChunks) {
+                unmapLeastRecent();
+            }
+            chunk.mapping = chunk.file->map(chunk.fileOffset, chunk.fileBytes);
+            if (!chunk.mapping.valid()) {
+                return nullptr;
+            }
+            mappedChunks.push_back(&chunk);
+        }
+        return chunk.mapping.data();
+    }
+
+    //     (     )
+    const char* unpackSegment(const Chunk& chunk) const {
+        for (const UnpackedChunk& entry : unpackedChunks) {
+            if (entry.chunk == &chunk) {
+                return entry.segment.get();
+            }
+        }
+
+        std::unique_ptr<char[]> segment(new char[chunk.segmentBytes]);
+        bool unpacked = false;
+        if (chunk.spilled()) {
+            //       
+            MappedRegion region = chunk.file->map(chunk.fileOffset, chunk.packedBytes);
+            unpacked = region.valid() &&
+                LzCodec::decompress(region.data(), chunk.packedBytes, segment.get(), chunk.segmentBytes);
+        }
+        else {
+            unpacked = LzCodec::decompress(chunk.packedData.get(), chunk.packedBytes, segment.get(), chunk.segmentBytes);
+        }
+        if (!unpacked) {
+            return nullptr;
+        }
+
+        if (unpackedChunks.size() >= MaxUnpackedChunks) {
+            size_t oldest = 0;
+            for (size_t i = 1; i < unpackedChunks.size(); ++i) {
+                if (unpackedChunks[i].chunk->lastUse < unpackedChunks[oldest].chunk->lastUse) {
+                    oldest = i;
+                }
+            }
+            unpackedChunks.erase(unpackedChunks.begin() + oldest);
+        }
+        UnpackedChunk entry = { &chunk, std::move(segment) };
+        unpackedChunks.push_back(std::move(entry));
+        return unpackedChunks.back().segment.get();
+    }
+
+    //     ,    
+    static ChunkColumns unavailableColumns(const Chunk& chunk) {
+        static const int64_t timestamps[LinesPerChunk] = {};
+        static const uint32_t offsets[LinesPerChunk] = {};
+        static const uint16_t sources[LinesPerChunk] = {};
+        static const uint8_t levels[LinesPerChunk] = {};
+        ChunkColumns columns = { chunk.firstId, chunk.lineCount, timestamps, offsets, sources, levels, "", 0 };
+        return columns;
+    }
+
+    //   ,   8 ,     
+    //    
+    static size_t columnBytes(size_t lines) {
+        return align8(lines * (sizeof(int64_t) + sizeof(uint32_t) + sizeof(uint16_t) + sizeof(uint8_t)));
+    }
+
+    static size_t align8(size_t value) {
+        return (value + 7) & ~static_cast<size_t>(7);
+    }
+
+    void unmapLeastRecent() const {
+        size_t oldest = 0;
+        for (size_t i = 1; i < mappedChunks.size(); ++i) {
+            if (mappedChunks[i]->lastUse < mappedChunks[oldest]->lastUse) {
+                oldest = i;
+            }
+        }
+        mappedChunks[oldest]->mapping.reset();
+        mappedChunks.erase(mappedChunks.begin() + oldest);
+    }
+
+    void forgetMapping(const Chunk* chunk) {
+        for (size_t i = 0; i < mappedChunks.size(); ++i) {
+            if (mappedChunks[i] == chunk) {
+                mappedChunks.erase(mappedChunks.begin() + i);
+                return;
+            }
+        }
+    }
+
+    void forgetUnpacked(const Chunk* chunk) {
+        for (size_t i = 0; i < unpackedChunks.size(); ++i) {
+            if (unpackedChunks[i].chunk == chunk) {
+                unpackedChunks.erase(unpackedChunks.begin() + i);
+                return;
+            }
+        }
+    }
+
+    //    .  ,   
+    //   ,       O(1) 
+    void pruneSpans() {
+        while (lineSpansStart < lineSpans.size() && lineSpans[lineSpansStart].id < first) {
+            ++lineSpansStart;
+        }
+        if (lineSpansStart == 0 || lineSpansStart * 2 < lineSpans.size()) {
+            return;
+        }
+        uint64_t keepFrom = lineSpansStart < lineSpans.size() ? lineSpans[lineSpansStart].firstSpan :
+            spansBase + colorSpans.size();
+        colorSpans.erase(colorSpans.begin(), colorSpans.begin() + static_cast<size_t>(keepFrom - spansBase));
+        spansBase = keepFrom;
+        lineSpans.erase(lineSpans.begin(), lineSpans.begin() + lineSpansStart);
+        lineSpansStart = 0;
+    }
+
+    Chunk* findChunk(uint64_t firstId) {
+        if (chunks.empty() || firstId < chunks.front()->firstId) {
+            return nullptr;
+        }
+        size_t index = static_cast<size_t>((firstId - chunks.front()->firstId) / LinesPerChunk);
+        return index < chunks.size() && chunks[index]->firstId == firstId ? chunks[index].get() : nullptr;
+    }
+
+    char* allocateLine(int64_t timestamp, uint8_t level, uint16_t source, size_t length) {
+        if (chunks.empty() || chunks.back()->lines() == LinesPerChunk) {
+            size_t expectedBytes = chunks.empty() ? 0 : chunks.back()->used + chunks.back()->used / 8;
+            //        -       
+            collectPacked();
+            requestPacking();
+            enforceBudget();
+            std::unique_ptr<Chunk> chunk = spare ? std::move(spare) : std::unique_ptr<Chunk>(new Chunk());
+            chunk->reset(next, expectedBytes);
+            chunks.push_back(std::move(chunk));
+        }
+        return chunks.back()->reserve(timestamp, level, source, length);
+    }
+
+    uint64_t commitLine() {
+        uint64_t id = next++;
+        if (next - first > maxLines) {
+            ++first;
+            //      -    
+            if (first - chunks.front()->firstId == LinesPerChunk) {
+                dropFront();
+            }
+        }
+        return id;
+    }
+
+    void dropFront() {
+        std::unique_ptr<Chunk> chunk = std::move(chunks.front());
+        chunks.pop_front();
+        forgetUnpacked(chunk.get());
+        repeats.erase(repeats.begin(), repeats.lower_bound(first));
+        pruneSpans();
+        if (chunk->spilled()) {
+            forgetMapping(chunk.get());
+            --spilledChunks;
+            if (chunk->file == spillFile) {
+                //      
+                if (spilledChunks == 0) {
+                    spillFile->truncate();
+                }
+                else {
+                    spillFile->release(chunk->fileOffset, chunk->fileBytes);
+                }
+            }
+        }
+        recycle(std::move(chunk));
+    }
+
+    //       ,   
+    //      .  ()    
+    void enforceBudget() {
+        if (memoryBudget == 0 || spillFailed || chunks.size() < 2) {
+            return;
+        }
+
+        size_t resident = 0;
+        for (size_t i = spilledChunks; i + 1 < chunks.size(); ++i) {
+            resident += chunks[i]->residentBytes();
+        }
+
+        while (resident > memoryBudget && spilledChunks + 1 < chunks.size()) {
+            Chunk& chunk = *chunks[spilledChunks];
+            size_t bytes = chunk.residentBytes();
+            if (!spill(chunk)) {
+                spillFailed = true;
+                return;
+            }
+            resident -= bytes;
+            ++spilledChunks;
+        }
+    }
+
+    //          
+    bool spill(Chunk& chunk) {
+        if (!spillFile) {
+            spillFile = SegmentFile::createTemporary();
+            if (!spillFile) {
+                return false;
+            }
+        }
+
+        static const char padding[8] = {};
+        if (chunk.compressed()) {
+            //           
+            const void* parts[] = { chunk.packedData.get(), padding };
+            size_t lengths[] = { chunk.packedBytes, align8(chunk.packedBytes) - chunk.packedBytes };
+            uint64_t offset = 0;
+            if (!spillFile->append(parts, lengths, 2, offset)) {
+                return false;
+            }
+            chunk.file = spillFile;
+            chunk.fileOffset = offset;
+            chunk.fileBytes = align8(chunk.packedBytes);
+            chunk.packedData.reset();
+            return true;
+        }
+
+        const void* parts[SegmentParts];
+        size_t lengths[SegmentParts];
+        segmentParts(chunk, parts, lengths);
+        uint64_t offset = 0;
+        if (!spillFile->append(parts, lengths, SegmentParts, offset)) {
+            return false;
+        }
+
+        chunk.file = spillFile;
+        chunk.fileOffset = offset;
+        chunk.fileBytes = segmentSize(chunk);
+        chunk.lineCount = chunk.offsets.size();
+        releaseBuffers(chunk);
+        return true;
+    }
+
+    static const size_t SegmentParts = 7;
+
+    static const char* sessionMagic() {
+        return "CMLOGSES";
+    }
+
+    //      .     ,  
+    //      ,  -    
+    bool writeSessionChunk(const Chunk& chunk, const std::vector<uint16_t>& toFile, bool identity,
+        SessionEntry& entry, std::string& error) {
+        static const char padding[8] = {};
+        ChunkColumns columns = columnsFor(chunk);
+        if (columns.used != chunk.used) {
+            error = u8"    ";
+            return false;
+        }
+        size_t lines = columns.lines;
+        entry = SessionEntry();
+        entry.firstTimestamp = columns.timestamps[0];
+        entry.lastTimestamp = columns.timestamps[lines - 1];
+        entry.lineCount = static_cast<uint32_t>(lines);
+        entry.usedBytes = static_cast<uint32_t>(chunk.used);
+
+        SegmentFile& file = *session.file;
+        if (chunk.compressed() && !chunk.sourceMap && identity) {
+            MappedRegion region;
+            const char* packed = chunk.packedData.get();
+            if (!packed) {
+                region = chunk.file->map(chunk.fileOffset, chunk.packedBytes);
+                packed = region.data();
+            }
+            const void* parts[] = { packed, padding };
+            size_t lengths[] = { chunk.packedBytes, align8(chunk.packedBytes) - chunk.packedBytes };
+            if (!packed || !file.append(parts, lengths, 2, entry.fileOffset)) {
+                error = u8"  ";
+                return false;
+            }
+            entry.fileBytes = chunk.packedBytes;
+            entry.segmentBytes = static_cast<uint32_t>(chunk.segmentBytes);
+            return true;
+        }
+
+        std::vector<uint16_t> translated;
+        const uint16_t* sources = columns.sources;
+        if (!identity) {
+            translated.resize(lines);
+            for (size_t i = 0; i < lines; ++i) {
+                translated[i] = sources[i] < toFile.size() ? toFile[sources[i]] : sources[i];
+            }
+            sources = translated.data();
+        }
+        size_t columnsSize = lines * (sizeof(int64_t) + sizeof(uint32_t) + sizeof(uint16_t) + sizeof(uint8_t));
+        const void* parts[SegmentParts] = {
+            columns.timestamps, columns.offsets, sources, columns.levels, padding, columns.data, padding
+        };
+        size_t lengths[SegmentParts] = {
+            lines * sizeof(int64_t), lines * sizeof(uint32_t), lines * sizeof(uint16_t), lines * sizeof(uint8_t),
+            columnBytes(lines) - columnsSize,
+            columns.used, align8(columns.used) - columns.used
+        };
+        if (!file.append(parts, lengths, SegmentParts, entry.fileOffset)) {
+            error = u8"  ";
+            return false;
+        }
+        entry.fileBytes = columnBytes(lines) + align8(columns.used);
+        return true;
+    }
+
+    //  ,     
+    bool writeSessionIndex(std::string& error) {
+        std::string names;
+        for (const std::string& channel : session.channels) {
+            uint16_t length = static_cast<uint16_t>(std::min<size_t>(channel.size(), UINT16_MAX));
+            names.append(reinterpret_cast<const char*>(&length), sizeof(length));
+            names.append(channel, 0, length);
+        }
+        SessionTrailer trailer = {};
+        memcpy(trailer.magic, sessionMagic(), sizeof(trailer.magic));
+        trailer.version = SessionVersion;
+        trailer.entryCount = static_cast<uint32_t>(session.entries.size());
+        trailer.indexOffset = session.file->getSize();
+        trailer.channelCount = static_cast<uint32_t>(session.channels.size());
+        trailer.channelBytes = static_cast<uint32_t>(names.size());
+
+        const void* parts[] = { session.entries.data(), names.data(), &trailer };
+        size_t lengths[] = { session.entries.size() * sizeof(SessionEntry), names.size(), sizeof(trailer) };
+        uint64_t offset = 0;
+        if (!session.file->append(parts, lengths, 3, offset) || !session.file->sync()) {
+            error = u8"  ";
+            return false;
+        }
+        return true;
+    }
+
+    //      
+    static bool readSessionIndex(const SegmentFile& file, SessionTrailer& trailer, std::vector<SessionEntry>& entries,
+        std::vector<std::string>& names, std::string& error) {
+        uint64_t fileSize = file.getSize();
+        MappedRegion trailerRegion = fileSize >= sizeof(trailer) ? file.map(fileSize - sizeof(trailer), sizeof(trailer)) :
+            MappedRegion();
+        if (!trailerRegion.valid()) {
+            error = u8"    ";
+            return false;
+        }
+        memcpy(&trailer, trailerRegion.data(), sizeof(trailer));
+        if (memcmp(trailer.magic, sessionMagic(), sizeof(trailer.magic)) != 0 || trailer.version != SessionVersion) {
+            error = u8"    ";
+            return false;
+        }
+
+        uint64_t entryBytes = static_cast<uint64_t>(trailer.entryCount) * sizeof(SessionEntry);
+        if (trailer.indexOffset > fileSize ||
+            fileSize - trailer.indexOffset != entryBytes + trailer.channelBytes + sizeof(trailer)) {
+            error = u8"  ";
+            return false;
+        }
+        entries.resize(trailer.entryCount);
+        names.clear();
+        if (entryBytes + trailer.channelBytes > 0) {
+            MappedRegion region = file.map(trailer.indexOffset, static_cast<size_t>(entryBytes + trailer.channelBytes));
+            if (!region.valid()) {
+                error = u8"    ";
+                return false;
+            }
+            memcpy(entries.data(), region.data(), static_cast<size_t>(entryBytes));
+            const char* p = region.data() + entryBytes;
+            const char* end = p + trailer.channelBytes;
+            for (uint32_t i = 0; i < trailer.channelCount; ++i) {
+                uint16_t length = 0;
+                if (end - p < static_cast<ptrdiff_t>(sizeof(length))) {
+                    break;
+                }
+                memcpy(&length, p, sizeof(length));
+                p += sizeof(length);
+                if (end - p < length) {
+                    break;
+                }
+                names.push_back(std::string(p, length));
+                p += length;
+            }
+        }
+
+        bool valid = names.size() == trailer.channelCount;
+        for (size_t i = 0; i < entries.size() && valid; ++i) {
+            const SessionEntry& entry = entries[i];
+            bool last = i + 1 == entries.size();
+            valid = entry.lineCount > 0 && entry.lineCount <= LinesPerChunk &&
+                (last || entry.lineCount == LinesPerChunk) &&
+                entry.fileOffset % 8 == 0 && entry.fileBytes <= trailer.indexOffset &&
+                entry.fileOffset <= trailer.indexOffset - entry.fileBytes &&
+                (entry.segmentBytes > 0 ?
+                    entry.segmentBytes >= columnBytes(entry.lineCount) + entry.usedBytes :
+                    entry.fileBytes == columnBytes(entry.lineCount) + align8(entry.usedBytes));
+        }
+        if (!valid) {
+            error = u8"  ";
+            return false;
+        }
+        return true;
+    }
+
+    //          
+    std::unique_ptr<Chunk> readChunk(const Chunk& source) {
+        std::unique_ptr<Chunk> chunk;
+        {
+            ChunkColumns columns = columnsFor(source);
+            if (columns.used == source.used) {
+                chunk.reset(new Chunk());
+                chunk->reset(source.firstId, columns.used);
+                for (size_t i = 0; i < columns.lines; ++i) {
+                    size_t length = static_cast<size_t>(columns.lineEnd(i) - columns.lineBegin(i));
+                    char* out = chunk->reserve(columns.timestamps[i], columns.levels[i], columns.sources[i], length);
+                    memcpy(out, columns.lineBegin(i), length);
+                }
+            }
+        }
+        forgetMapping(&source);
+        forgetUnpacked(&source);
+        source.mapping.reset();
+        return chunk;
+    }
+
+    //    :   ,     8 
+    static void segmentParts(const Chunk& chunk, const void** parts, size_t* lengths) {
+        static const char padding[8] = {};
+        size_t lines = chunk.offsets.size();
+        size_t columnsSize = lines * (sizeof(int64_t) + sizeof(uint32_t) + sizeof(uint16_t) + sizeof(uint8_t));
+        const void* chunkParts[SegmentParts] = {
+            chunk.timestamps.data(), chunk.offsets.data(), chunk.sources.data(), chunk.levels.data(), padding,
+            chunk.data.get(), padding
+        };
+        size_t chunkLengths[SegmentParts] = {
+            lines * sizeof(int64_t), lines * sizeof(uint32_t), lines * sizeof(uint16_t), lines * sizeof(uint8_t),
+            columnBytes(lines) - columnsSize,
+            chunk.used, align8(chunk.used) - chunk.used
+        };
+        std::copy(chunkParts, chunkParts + SegmentParts, parts);
+        std::copy(chunkLengths, chunkLengths + SegmentParts, lengths);
+    }
+
+    static size_t segmentSize(const Chunk& chunk) {
+        return columnBytes(chunk.offsets.size()) + align8(chunk.used);
+    }
+
+    //        ,  KeepRawChunks .
+    //      
+    void requestPacking() {
+        if (memoryBudget == 0) {
+            return;
+        }
+        for (size_t i = spilledChunks; i + KeepRawChunks < chunks.size(); ++i) {
+            Chunk& chunk = *chunks[i];
+            if (!chunk.raw() || chunk.packRequested) {
+                continue;
+            }
+            const void* parts[SegmentParts];
+            size_t lengths[SegmentParts];
+            segmentParts(chunk, parts, lengths);
+            ChunkPacker::Job job;
+            job.firstId = chunk.firstId;
+            job.segment.resize(segmentSize(chunk));
+            char* out = job.segment.data();
+            for (size_t part = 0; part < SegmentParts; ++part) {
+                memcpy(out, parts[part], lengths[part]);
+                out += lengths[part];
+            }
+            if (!packer) {
+                packer.reset(new ChunkPacker());
+            }
+            packer->submit(std::move(job));
+            chunk.packRequested = true;
+        }
+    }
+
+    //  ,       ,   
+    void releaseBuffers(Chunk& chunk) {
+        if (!spare) {
+            spare.reset(new Chunk());
+            chunk.giveBuffers(*spare);
+        }
+        else {
+            std::unique_ptr<Chunk> released(new Chunk());
+            chunk.giveBuffers(*released);
+        }
+    }
+
+    void recycle(std::unique_ptr<Chunk> chunk) {
+        if (!spare && !chunk->spilled()) {
+            spare = std::move(chunk);
+        }
+    }
+};
\ No newline at end of file
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+#include "LogStore.h"
+#include "TextMatch.h"
+
+//   :    ,
+//    ,   .    .
+//   :   update()  
+// ,    ,     .
+//          , 
+//           .
+//       -  N   firstId() + N.
+//      (,    )
+//     ,    
+class LogView {
+private:
+    uint8_t minLevel;
+    std::vector<uint16_t> channels;         //   ( - )
+    std::vector<uint8_t> channelAllowed;    //  channels   
+    TextFilter textFilter;
+    std::vector<uint8_t> passes;    //      
+    std::vector<uint64_t> ids;
+    size_t start;           //    ids ( -  )
+    uint64_t scannedTo;     //      
+
+public:
+    LogView() : minLevel(0), start(0), scannedTo(0) {}
+
+    //  :  ,   ( - )  .
+    //      
+    void setFilter(uint8_t level, const std::vector<uint16_t>& allowed, const char* text) {
+        bool textChanged = textFilter.parse(text);
+        if (level == minLevel && allowed == channels && !textChanged) {
+            return;
+        }
+        minLevel = level;
+        channels = allowed;
+        channelAllowed.assign(channels.empty() ? 0 : *std::max_element(channels.begin(), channels.end()) + 1, 0);
+        for (uint16_t channel : channels) {
+            channelAllowed[channel] = 1;
+        }
+        reset();
+    }
+
+    bool isFiltered() const {
+        return minLevel > 0 || !channels.empty() || !textFilter.empty();
+    }
+
+    //       
+    bool isComplete(const LogStore& store) const {
+        return !isFiltered() || scannedTo >= store.endId();
+    }
+
+    //  ,      .
+    //    ,    budget
+    void update(const LogStore& store, std::chrono::microseconds budget) {
+        if (!isFiltered()) {
+            return;
+        }
+
+        while (start < ids.size() && ids[start] < store.firstId()) {
+            ++start;
+        }
+        //  ,      
+        if (start > 0 && start * 2 >= ids.size()) {
+            ids.erase(ids.begin(), ids.begin() + start);
+            start = 0;
+        }
+
+        if (scannedTo < store.firstId()) {
+            scannedTo = store.firstId();
+        }
+        if (textFilter.empty() && channels.size() <= 1) {
+            int source = channels.empty() ? LogStore::AnySource : channels[0];
+            store.scan(scannedTo, store.endId(), minLevel, source, [this](uint64_t id) {
+                ids.push_back(id);
+                });
+            scannedTo = store.endId();
+            return;
+        }
+
+        auto deadline = std::chrono::steady_clock::now() + budget;
+        store.scanChunks(scannedTo, store.endId(), [&](const LogStore::ChunkColumns& columns, size_t pos, size_t end) {
+            passes.resize(end - pos);
+            if (textFilter.empty()) {
+                std::fill(passes.begin(), passes.end(), 1);
+            }
+            else {
+                textFilter.matchLines(columns, pos, end, passes.data());
+            }
+            for (size_t i = pos; i < end; ++i) {
+                if (passes[i - pos] && columns.levels[i] >= minLevel && channelPasses(columns.sources[i])) {
+                    ids.push_back(columns.firstId + i);
+                }
+            }
+            scannedTo = columns.firstId + end;
+            return std::chrono::steady_clock::now() < deadline;
+            });
+    }
+
+    //    
+    size_t size(const LogStore& store) const {
+        return isFiltered() ? ids.size() - start : store.size();
+    }
+
+    //      
+    uint64_t idAt(const LogStore& store, size_t row) const {
+        return isFiltered() ? ids[start + row] : store.firstId() + row;
+    }
+
+    //      
+    bool rowOf(const LogStore& store, uint64_t id, size_t& row) const {
+        if (!store.contains(id)) {
+            return false;
+        }
+        if (!isFiltered()) {
+            row = static_cast<size_t>(id - store.firstId());
+            return true;
+        }
+        auto it = std::lower_bound(ids.begin() + start, ids.end(), id);
+        if (it == ids.end() || *it != id) {
+            return false;
+        }
+        row = static_cast<size_t>(it - (ids.begin() + start));
+        return true;
+    }
+
+    bool channelPasses(uint16_t channel) const {
+        return channels.empty() || (channel < channelAllowed.size() && channelAllowed[channel]);
+    }
+
+    void reset() {
+        ids.clear();
+        start = 0;
+        scannedTo = 0;
+    }
+};
\ No newline at end of file
@@ -0,0 +1,524 @@
+#pragma once
+
+#include <string>
+#include <chrono>
+#include <ctime>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <iterator>
+#include <algorithm>
+
+#include "LogStore.h"
+#include "MpscQueue.h"
+#include "TrigramIndex.h"
+#include "AnsiParser.h"
+
+//   
+enum class LogLevel : uint8_t {
+    Trace,
+    Debug,
+    Info,
+    Warning,
+    Error,
+    Count
+};
+
+// ,    .
+//        : text 
+//  , lineEnds -     '\n'
+struct LogMessage {
+    int64_t timestamp;      //    system_clock
+    LogLevel level;
+    uint16_t source;        //   () 
+    std::string text;
+    std::vector<uint32_t> lineEnds;     //  -     text
+    std::vector<uint8_t> lineLevels;    //    ( -   level)
+};
+
+//      "[::.]".
+//  localtime/strftime     :  
+// "[::"    ,    
+class TimestampFormatter {
+private:
+    static const size_t CacheSize = 64;
+    static const size_t PrefixLength = 9;
+
+    struct Entry {
+        int64_t second;
+        char prefix[PrefixLength + 1];
+    };
+
+    Entry cache[CacheSize];
+
+public:
+    static const size_t MaxLength = PrefixLength + 5;
+
+    TimestampFormatter() {
+        for (size_t i = 0; i < CacheSize; ++i) {
+            cache[i].second = INT64_MIN;
+        }
+    }
+
+    //     (  MaxLength ),  
+    size_t format(int64_t timestamp, char* buffer) {
+        int64_t second = timestamp / 1000000000;
+        int64_t remainder = timestamp % 1000000000;
+        if (remainder < 0) {
+            remainder += 1000000000;
+            --second;
+        }
+
+        Entry& entry = cache[static_cast<uint64_t>(second) % CacheSize];
+        if (entry.second != second) {
+            std::time_t time = static_cast<std::time_t>(second);
+            std::tm tm_buf;
+#ifdef _WIN32
+            localtime_s(&tm_buf, &time);
+#else
+            localtime_r(&time, &tm_buf);
+#endif
+            strftime(entry.prefix, sizeof(entry.prefix), "[%H:%M:%S", &tm_buf);
+            entry.second = second;
+        }
+
+        int milliseconds = static_cast<int>(remainder / 1000000);
+        memcpy(buffer, entry.prefix, PrefixLength);
+        buffer[PrefixLength] = '.';
+        buffer[PrefixLength + 1] = static_cast<char>('0' + milliseconds / 100);
+        buffer[PrefixLength + 2] = static_cast<char>('0' + milliseconds / 10 % 10);
+        buffer[PrefixLength + 3] = static_cast<char>('0' + milliseconds % 10);
+        buffer[PrefixLength + 4] = ']';
+        return MaxLength;
+    }
+};
+
+//     .
+// ,      repeatWindow    (  ),
+//     ,      .
+//    ,      -  .
+// log()  logBatch()     :    
+//      .       UI,
+//           drain().
+// drain()   :    ,   
+// ,      .   
+// MaxPendingBytes:      (   ),
+//  drain() ,   . ,   
+// ( ),      waitForQueueSpace()
+class Logger {
+private:
+    LogStore logs;
+    MpscQueue<LogMessage> pending;
+    std::atomic<size_t> pendingBytes;       //    
+    std::atomic<uint64_t> droppedLines;     //    drain()
+    std::mutex spaceMutex;
+    std::condition_variable spaceFreed;     // drain()    
+    TrigramIndex searchIndex;
+
+    LogMessage draining;        // ,     
+    size_t drainingLine;        //    draining
+    bool hasDraining;
+
+    mutable std::mutex channelsMutex;
+    std::vector<std::string> channels;
+
+public:
+    //    -   
+    static const uint16_t ConsoleChannel = 0;
+    static const size_t MaxRepeatWindow = 16;
+    //  :           1 
+    static const size_t MaxPendingBytes = 256 * 1024 * 1024;
+
+private:
+    //     -    
+    struct RecentLines {
+        uint64_t ids[MaxRepeatWindow];
+        uint64_t hashes[MaxRepeatWindow];
+        size_t next;            // ,     
+    };
+
+    std::vector<RecentLines> recentLines;  //   
+    size_t repeatWindow;                    // 0 -   
+
+    std::vector<AnsiParser> ansiParsers;    //   
+    std::string plainText;                  //    escape-
+    std::vector<ColorSpan> plainSpans;
+
+public:
+    Logger(size_t maxLines = 50000000) :
+        logs(maxLines),
+        pendingBytes(0),
+        droppedLines(0),
+        drainingLine(0),
+        hasDraining(false),
+        repeatWindow(1) {
+        channels.push_back("console");
+    }
+    std::string statusMessage;
+    std::chrono::steady_clock::time_point statusTime;
+
+    //     (  )
+    void log(const std::string& message) {
+        log(LogLevel::Info, ConsoleChannel, message.data(), message.size());
+    }
+
+    void log(LogLevel level, const std::string& message) {
+        log(level, ConsoleChannel, message.data(), message.size());
+    }
+
+    //    :       
+    void log(LogLevel level, uint16_t channel, const char* text, size_t length) {
+        LogMessage entry;
+        entry.timestamp = currentTimestamp();
+        entry.level = level;
+        entry.source = channel;
+        entry.text.assign(text, length);
+        pendingBytes.fetch_add(messageBytes(entry), std::memory_order_relaxed);
+        pending.push(std::move(entry));
+    }
+
+    //    (  ). lineEnds -  '\n'  text;
+    //   '\r'   .  mayDrop == false 
+    //      (   )
+    void logBatch(LogLevel level, uint16_t channel, std::string&& text, std::vector<uint32_t>&& lineEnds,
+        bool mayDrop = true) {
+        LogMessage entry;
+        entry.timestamp = currentTimestamp();
+        entry.level = level;
+        entry.source = channel;
+        entry.text = std::move(text);
+        entry.lineEnds = std::move(lineEnds);
+        pushBatch(std::move(entry), mayDrop);
+    }
+
+    //        
+    void logBatch(uint16_t channel, std::string&& text, std::vector<uint32_t>&& lineEnds,
+        std::vector<uint8_t>&& lineLevels) {
+        LogMessage entry;
+        entry.timestamp = currentTimestamp();
+        entry.level = LogLevel::Info;
+        entry.source = channel;
+        entry.text = std::move(text);
+        entry.lineEnds = std::move(lineEnds);
+        entry.lineLevels = std::move(lineLevels);
+        pushBatch(std::move(entry), true);
+    }
+
+    //      (  )
+    bool hasQueueSpace() const {
+        return pendingBytes.load(std::memory_order_relaxed) < MaxPendingBytes;
+    }
+
+    //       timeout (  ). false -  :
+    //         
+    bool waitForQueueSpace(std::chrono::milliseconds timeout) {
+        std::unique_lock<std::mutex> lock(spaceMutex);
+        return spaceFreed.wait_for(lock, timeout, [this]() { return hasQueueSpace(); });
+    }
+
+    //   ( )    .
+    //      
+    uint16_t registerChannel(const std::string& name) {
+        std::lock_guard<std::mutex> lock(channelsMutex);
+        for (size_t i = 0; i < channels.size(); ++i) {
+            if (channels[i] == name) {
+                return static_cast<uint16_t>(i);
+            }
+        }
+        channels.push_back(name);
+        return static_cast<uint16_t>(channels.size() - 1);
+    }
+
+    //    
+    std::string getChannelName(uint16_t channel) const {
+        std::lock_guard<std::mutex> lock(channelsMutex);
+        return channel < channels.size() ? channels[channel] : std::string();
+    }
+
+    //   
+    size_t getChannelCount() const {
+        std::lock_guard<std::mutex> lock(channelsMutex);
+        return channels.size();
+    }
+
+    //     ,    budget.
+    //    
+    size_t drain(std::chrono::microseconds budget) {
+        auto deadline = std::chrono::steady_clock::now() + budget;
+        size_t count = 0;
+        uint64_t dropped = droppedLines.exchange(0, std::memory_order_relaxed);
+        if (dropped > 0) {
+            std::string message = u8"  ,  : " + std::to_string(dropped);
+            store(currentTimestamp(), LogLevel::Warning, ConsoleChannel, message.data(), message.size());
+            ++count;
+        }
+        while (hasDraining || popPending(draining)) {
+            if (draining.lineEnds.empty()) {
+                store(draining.timestamp, draining.level, draining.source, draining.text.data(), draining.text.size());
+                ++count;
+            }
+            else {
+                if (!hasDraining) {
+                    drainingLine = 0;
+                    hasDraining = true;
+                }
+                count += storeBatch(deadline);
+                if (hasDraining) {
+                    break;
+                }
+            }
+            if (std::chrono::steady_clock::now() > deadline) {
+                break;
+            }
+        }
+        if (searchIndex.getIndexedEnd() < logs.endId()) {
+            indexBacklog(deadline);
+        }
+        if (count > 0) {
+            searchIndex.prune(logs.firstId());
+        }
+        logs.collectPacked();
+        if (count > 0) {
+            std::lock_guard<std::mutex> lock(spaceMutex);
+            spaceFreed.notify_all();
+        }
+        return count;
+    }
+
+    //   ,      (   UI)
+    bool hasPending() const {
+        return hasDraining || !pending.empty();
+    }
+
+    void setStatusMessage(const std::string& message) {
+
+        statusMessage =  message;
+        statusTime = std::chrono::steady_clock::now();
+    }
+
+    //   
+    const LogStore& getLogs() const {
+        return logs;
+    }
+
+    //        (0 -  , 1 -  )
+    void setRepeatWindow(size_t lines) {
+        repeatWindow = lines < MaxRepeatWindow ? lines : MaxRepeatWindow;
+        recentLines.clear();
+    }
+
+    size_t getRepeatWindow() const {
+        return repeatWindow;
+    }
+
+    //     ;      
+    void setMemoryBudget(size_t bytes) {
+        logs.setMemoryBudget(bytes);
+    }
+
+    //  ,     
+    void clearLogs() {
+        LogMessage entry;
+        while (popPending(entry)) {
+        }
+        hasDraining = false;
+        recentLines.clear();
+        ansiParsers.clear();
+        logs.clear();
+        searchIndex.clear(logs.endId());
+    }
+
+    //     .      
+    //    
+    bool saveSession(const std::string& path, std::string& error) {
+        std::vector<std::string> names;
+        {
+            std::lock_guard<std::mutex> lock(channelsMutex);
+            names = channels;
+        }
+        return logs.saveSession(path, names, error);
+    }
+
+    //      .     ;
+    //         .
+    //   ,   :     
+    bool loadSession(const std::string& path, std::string& error) {
+        if (!logs.loadSession(path, [this](const std::string& name) { return registerChannel(name); }, error)) {
+            return false;
+        }
+        LogMessage entry;
+        while (popPending(entry)) {
+        }
+        hasDraining = false;
+        recentLines.clear();
+        ansiParsers.clear();
+        searchIndex.clear(logs.firstId());
+        return true;
+    }
+
+    //  ,   (   ),   limit.
+    //  false,    limit (  results -  )
+    bool find(const std::string& query, std::vector<uint64_t>& results, size_t limit) const {
+        return searchIndex.find(logs, query, results, limit);
+    }
+
+    //        (TrigramIndex::Search::step)
+    void startSearch(const std::string& query, size_t limit, TrigramIndex::Search& search) const {
+        searchIndex.start(logs, query, limit, search);
+    }
+
+    //       system_clock
+    static int64_t currentTimestamp() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+
+private:
+    static size_t messageBytes(const LogMessage& entry) {
+        return entry.text.size() + entry.lineEnds.size() * sizeof(uint32_t) + entry.lineLevels.size();
+    }
+
+    //     ,    ,  .
+    //      ,      
+    void pushBatch(LogMessage&& entry, bool mayDrop) {
+        size_t bytes = messageBytes(entry);
+        size_t queued = pendingBytes.load(std::memory_order_relaxed);
+        if (mayDrop && queued > 0 && queued + bytes > MaxPendingBytes) {
+            droppedLines.fetch_add(entry.lineEnds.empty() ? 1 : entry.lineEnds.size(), std::memory_order_relaxed);
+            return;
+        }
+        pendingBytes.fetch_add(bytes, std::memory_order_relaxed);
+        pending.push(std::move(entry));
+    }
+
+    bool popPending(LogMessage& entry) {
+        if (!pending.pop(entry)) {
+            return false;
+        }
+        pendingBytes.fetch_sub(messageBytes(entry), std::memory_order_relaxed);
+        return true;
+    }
+
+    //          
+    void store(int64_t timestamp, LogLevel level, uint16_t source, const char* text, size_t length) {
+        //  ANSI    ;      
+        if (source >= ansiParsers.size()) {
+            ansiParsers.resize(source + 1);
+        }
+        const ColorSpan* spans = nullptr;
+        size_t spanCount = 0;
+        if (ansiParsers[source].parse(text, length, plainText, plainSpans)) {
+            text = plainText.data();
+            length = plainText.size();
+            spans = plainSpans.data();
+            spanCount = plainSpans.size();
+        }
+
+        if (repeatWindow == 0) {
+            appendLine(timestamp, level, source, text, length, spans, spanCount);
+            return;
+        }
+
+        if (source >= recentLines.size()) {
+            RecentLines empty;
+            std::fill(std::begin(empty.ids), std::end(empty.ids), UINT64_MAX);
+            std::fill(std::begin(empty.hashes), std::end(empty.hashes), 0);
+            empty.next = 0;
+            recentLines.resize(source + 1, empty);
+        }
+        RecentLines& recent = recentLines[source];
+        uint64_t hash = hashText(text, length) ^ static_cast<uint64_t>(level);
+        for (size_t i = 0; i < repeatWindow; ++i) {
+            if (recent.hashes[i] == hash && sameLine(recent.ids[i], level, text, length)) {
+                logs.addRepeat(recent.ids[i], timestamp);
+                return;
+            }
+        }
+
+        uint64_t id = appendLine(timestamp, level, source, text, length, spans, spanCount);
+        recent.ids[recent.next] = id;
+        recent.hashes[recent.next] = hash;
+        recent.next = (recent.next + 1) % repeatWindow;
+    }
+
+    uint64_t appendLine(int64_t timestamp, LogLevel level, uint16_t source, const char* text, size_t length,
+        const ColorSpan* spans, size_t spanCount) {
+        uint64_t id = logs.append(timestamp, static_cast<uint8_t>(level), source, text, length);
+        //     ,     
+        if (searchIndex.getIndexedEnd() == id) {
+            searchIndex.add(id, text, length);
+        }
+        if (spanCount > 0) {
+            logs.setSpans(id, spans, spanCount);
+        }
+        return id;
+    }
+
+    //    ,     
+    // ( ),     
+    void indexBacklog(std::chrono::steady_clock::time_point deadline) {
+        logs.scanChunks(searchIndex.getIndexedEnd(), logs.endId(), [&](const LogStore::ChunkColumns& columns, size_t pos, size_t end) {
+            for (; pos < end; ++pos) {
+                const char* begin = columns.lineBegin(pos);
+                searchIndex.add(columns.firstId + pos, begin, static_cast<size_t>(columns.lineEnd(pos) - begin));
+                if ((pos & 255) == 255 && std::chrono::steady_clock::now() > deadline) {
+                    return false;
+                }
+            }
+            return true;
+            });
+    }
+
+    //     id   (  )
+    bool sameLine(uint64_t id, LogLevel level, const char* text, size_t length) const {
+        if (!logs.contains(id)) {
+            return false;
+        }
+        LogLine line = logs.line(id);
+        return line.level == static_cast<uint8_t>(level) && line.size() == length &&
+            memcmp(line.begin, text, length) == 0;
+    }
+
+    //   :  8   ,  - 
+    static uint64_t hashText(const char* text, size_t length) {
+        const uint64_t prime = 0x100000001b3ull;
+        uint64_t hash = 0xcbf29ce484222325ull ^ length;
+        size_t i = 0;
+        for (; i + 8 <= length; i += 8) {
+            uint64_t word;
+            memcpy(&word, text + i, sizeof(word));
+            hash = (hash ^ word) * prime;
+            hash ^= hash >> 29;
+        }
+        for (; i < length; ++i) {
+            hash = (hash ^ static_cast<uint8_t>(text[i])) * prime;
+        }
+        return hash;
+    }
+
+    //    draining,    256 
+    size_t storeBatch(std::chrono::steady_clock::time_point deadline) {
+        const std::vector<uint32_t>& ends = draining.lineEnds;
+        const char* text = draining.text.data();
+        size_t count = 0;
+        while (drainingLine < ends.size()) {
+            size_t begin = drainingLine > 0 ? ends[drainingLine - 1] + 1 : 0;
+            size_t end = ends[drainingLine];
+            if (end > begin && text[end - 1] == '\r') {
+                --end;
+            }
+            LogLevel level = draining.lineLevels.empty() ? draining.level :
+                static_cast<LogLevel>(draining.lineLevels[drainingLine]);
+            store(draining.timestamp, level, draining.source, text + begin, end - begin);
+            ++drainingLine;
+            if ((++count & 255) == 0 && std::chrono::steady_clock::now() > deadline) {
+                return count;
+            }
+        }
+        hasDraining = false;
+        return count;
+    }
+};
\ No newline at end of file
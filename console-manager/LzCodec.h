@@ -0,0 +1,176 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+//      LZ4:   ,  
+//    .  -   " + ":
+// - ( 4  -  ,  -    MinMatch,
+//  15       255), ,
+//   (2 , little-endian)    .
+//     .      
+//        
+namespace LzCodec {
+
+    static const size_t MinMatch = 4;
+    static const size_t LastLiterals = 8;      //     
+    static const size_t MaxOffset = 65535;
+    static const int HashBits = 14;
+
+    //        length
+    inline size_t compressBound(size_t length) {
+        return length + length / 255 + 16;
+    }
+
+    inline uint32_t read32(const char* p) {
+        uint32_t value;
+        memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    inline char* writeLength(char* out, size_t length) {
+        while (length >= 255) {
+            *out++ = static_cast<char>(255);
+            length -= 255;
+        }
+        *out++ = static_cast<char>(length);
+        return out;
+    }
+
+    inline char* writeSequence(char* out, const char* literals, size_t literalLength, size_t offset, size_t matchLength) {
+        char* token = out++;
+        size_t matchCode = matchLength - MinMatch;
+        *token = static_cast<char>(((literalLength < 15 ? literalLength : 15) << 4) | (matchCode < 15 ? matchCode : 15));
+        if (literalLength >= 15) {
+            out = writeLength(out, literalLength - 15);
+        }
+        memcpy(out, literals, literalLength);
+        out += literalLength;
+        *out++ = static_cast<char>(offset & 0xFF);
+        *out++ = static_cast<char>(offset >> 8);
+        if (matchCode >= 15) {
+            out = writeLength(out, matchCode - 15);
+        }
+        return out;
+    }
+
+    //  length   source  target (  compressBound(length)).
+    //    
+    inline size_t compress(const char* source, size_t length, char* target) {
+        std::vector<uint32_t> table(static_cast<size_t>(1) << HashBits, 0);
+        char* out = target;
+        size_t anchor = 0;
+        size_t pos = 0;
+
+        if (length > MinMatch + LastLiterals) {
+            size_t matchLimit = length - LastLiterals;
+            while (pos + MinMatch <= matchLimit) {
+                uint32_t sequence = read32(source + pos);
+                uint32_t hash = (sequence * 2654435761u) >> (32 - HashBits);
+                size_t candidate = table[hash];
+                table[hash] = static_cast<uint32_t>(pos);
+
+                if (candidate >= pos || pos - candidate > MaxOffset || read32(source + candidate) != sequence) {
+                    //    ,   :    
+                    pos += 1 + ((pos - anchor) >> 6);
+                    continue;
+                }
+
+                //         
+                while (pos > anchor && candidate > 0 && source[pos - 1] == source[candidate - 1]) {
+                    --pos;
+                    --candidate;
+                }
+                size_t matchLength = MinMatch;
+                while (pos + matchLength < matchLimit && source[pos + matchLength] == source[candidate + matchLength]) {
+                    ++matchLength;
+                }
+
+                out = writeSequence(out, source + anchor, pos - anchor, pos - candidate, matchLength);
+                pos += matchLength;
+                anchor = pos;
+            }
+        }
+
+        //  
+        size_t literalLength = length - anchor;
+        *out++ = static_cast<char>((literalLength < 15 ? literalLength : 15) << 4);
+        if (literalLength >= 15) {
+            out = writeLength(out, literalLength - 15);
+        }
+        memcpy(out, source + anchor, literalLength);
+        out += literalLength;
+        return static_cast<size_t>(out - target);
+    }
+
+    //    target   length . false -  
+    inline bool decompress(const char* source, size_t sourceLength, char* target, size_t length) {
+        const unsigned char* in = reinterpret_cast<const unsigned char*>(source);
+        const unsigned char* inEnd = in + sourceLength;
+        char* out = target;
+        char* outEnd = target + length;
+
+        while (in < inEnd) {
+            unsigned token = *in++;
+
+            size_t literalLength = token >> 4;
+            if (literalLength == 15) {
+                unsigned char next;
+                do {
+                    if (in >= inEnd) {
+                        return false;
+                    }
+                    next = *in++;
+                    literalLength += next;
+                } while (next == 255);
+            }
+            if (literalLength > static_cast<size_t>(inEnd - in) || literalLength > static_cast<size_t>(outEnd - out)) {
+                return false;
+            }
+            memcpy(out, in, literalLength);
+            in += literalLength;
+            out += literalLength;
+
+            if (in == inEnd) {
+                break;
+            }
+
+            if (inEnd - in < 2) {
+                return false;
+            }
+            size_t offset = static_cast<size_t>(in[0]) | (static_cast<size_t>(in[1]) << 8);
+            in += 2;
+            size_t matchLength = token & 15;
+            if (matchLength == 15) {
+                unsigned char next;
+                do {
+                    if (in >= inEnd) {
+                        return false;
+                    }
+                    next = *in++;
+                    matchLength += next;
+                } while (next == 255);
+            }
+            matchLength += MinMatch;
+            if (offset == 0 || offset > static_cast<size_t>(out - target) ||
+                matchLength > static_cast<size_t>(outEnd - out)) {
+                return false;
+            }
+
+            const char* match = out - offset;
+            if (offset >= matchLength) {
+                memcpy(out, match, matchLength);
+                out += matchLength;
+            }
+            else {
+                //   (,   )   
+                for (size_t i = 0; i < matchLength; ++i) {
+                    *out++ = match[i];
+                }
+            }
+        }
+        return out == outEnd;
+    }
+}
\ No newline at end of file
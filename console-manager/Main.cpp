@@ -10,142 +10,458 @@
 #include <map>
 #include <functional>
 #include <vector>
-#include <sstream>
 #include <memory>
 #include <chrono>
+#include <algorithm>
+#include <climits>
+#include <cstdio>
+#include <filesystem>
+
+#include "RingBuffer.h"
+#include "Logger.h"
+#include "LogView.h"
+#include "TextMatch.h"
+#include "FileTail.h"
+#include "StreamReader.h"
+#include "ProcessManager.h"
+#include "DatagramReceiver.h"
+#include "WrapLayout.h"
+#include "VirtualScroll.h"
+#include "CommandLine.h"
+#include "CommandSignature.h"
+#include "CommandPipeline.h"
+#include "CommandScript.h"
+#include "CommandTrie.h"
+
+//     
+template <>
+struct CommandEnum<LogLevel> {
+    static constexpr const char* names[] = { "trace", "debug", "info", "warning", "error" };
+};
+
+//    
+class CommandProcessor {
+public:
+    //  :   candidates   index
+    // (0 -    ),   prefix
+    using Completer = std::function<void(size_t index, std::string_view prefix, std::vector<std::string>& candidates)>;
 
-//     
-class Logger {
 private:
-    std::vector<std::string> logs;
-    size_t maxLines;
+    using CommandFunction = std::function<void(const CommandArgs&)>;
+    std::map<std::string, CommandFunction, std::less<>> commands;
+    std::map<std::string, CommandPipeline::StageFunction, std::less<>> streamCommands;   //   
+    std::map<std::string, std::string> commandDescriptions;
+    std::shared_ptr<Logger> logger;
+    CommandJobs jobs;               //   
+    std::vector<std::unique_ptr<CommandScript>> scripts;    //   ( - )
+    CommandTrie commandNames;       //     
+    std::map<std::string, Completer, std::less<>> completers;
+
+    static const size_t MaxScriptDepth = 16;
+    static const size_t MaxScriptErrors = 10;
+    static const size_t MaxCompletions = 50;
 
 public:
-    Logger(size_t maxLines = 1000) : maxLines(maxLines) {}
-    std::string statusMessage;
-    std::chrono::steady_clock::time_point statusTime;
+    CommandProcessor(std::shared_ptr<Logger> logger) : logger(logger) {}
 
-    //    
-    void log(const std::string& message) {
-        std::string timestampedMessage = getTimestamp() + u8" " + message;
-        logs.push_back(timestampedMessage);
-        if (logs.size() > maxLines) {
-            logs.erase(logs.begin());
-        }
+    //   
+    void registerCommand(const std::string& name, CommandFunction callback, const std::string& description = "") {
+        commands[name] = callback;
+        commandDescriptions[name] = description;
+        commandNames.insert(name);
     }
 
-    void setStatusMessage(const std::string& message) {
-
-        statusMessage =  message;
-        statusTime = std::chrono::steady_clock::now();
+    //   :      
+    //    .         
+    void registerStreamCommand(const std::string& name, CommandPipeline::StageFunction stage, const std::string& description) {
+        streamCommands[name] = stage;
+        commandNames.insert(name);
+        std::string& help = commandDescriptions[name];
+        help = help.empty() ? description : help + u8";  : " + description;
     }
 
-    //   
-    const std::vector<std::string>& getLogs() const {
-        return logs;
+    //     (     )
+    void setCompleter(const std::string& name, Completer completer) {
+        completers[name] = completer;
     }
 
-    //  
-    void clearLogs() {
-        logs.clear();
-    }
+    //    ( )  Tab:   -   ,
+    //  -   .  completed -  ;  
+    // ,  options -   ,   total -  . false -  
+    bool complete(std::string_view input, std::string& completed, std::vector<std::string>& options, size_t& total) const {
+        //         
+        size_t tokenStart = input.size();
+        size_t index = 0;
+        std::string_view stageName;
+        bool inToken = false;
+        char quote = 0;
+        for (size_t i = 0; i < input.size(); ++i) {
+            char c = input[i];
+            if (quote) {
+                quote = c == quote ? 0 : quote;
+            }
+            else if (c == ' ' || c == '\t' || c == '|') {
+                if (inToken) {
+                    if (index == 0) {
+                        stageName = input.substr(tokenStart, i - tokenStart);
+                    }
+                    ++index;
+                    inToken = false;
+                }
+                if (c == '|') {
+                    index = 0;
+                }
+            }
+            else {
+                if (!inToken) {
+                    inToken = true;
+                    tokenStart = i;
+                }
+                if (c == '"' || c == '\'') {
+                    quote = c;
+                }
+            }
+        }
+        if (!inToken) {
+            tokenStart = input.size();
+        }
+        std::string_view token = input.substr(tokenStart);
+        bool quoted = !token.empty() && (token[0] == '"' || token[0] == '\'');
+        std::string_view prefix = quoted ? token.substr(1) : token;
 
-private:
-    //     
-    std::string getTimestamp() {
-        auto now = std::chrono::system_clock::now();
-        auto time = std::chrono::system_clock::to_time_t(now);
-        std::tm tm_buf;
-#ifdef _WIN32
-        localtime_s(&tm_buf, &time);
-#else
-        localtime_r(&time, &tm_buf);
-#endif
-        char buffer[80];
-        strftime(buffer, sizeof(buffer), "[%H:%M:%S]", &tm_buf);
-        return std::string(buffer);
+        std::string extension;
+        if (index == 0) {
+            total = commandNames.complete(prefix, extension, options, MaxCompletions);
+        }
+        else {
+            auto it = completers.find(stageName);
+            if (it == completers.end()) {
+                return false;
+            }
+            std::vector<std::string> candidates;
+            it->second(index - 1, prefix, candidates);
+            options.clear();
+            for (std::string& candidate : candidates) {
+                if (candidate.compare(0, prefix.size(), prefix.data(), prefix.size()) == 0) {
+                    options.push_back(std::move(candidate));
+                }
+            }
+            std::sort(options.begin(), options.end());
+            options.erase(std::unique(options.begin(), options.end()), options.end());
+            total = options.size();
+            if (total > 0) {
+                //  :       
+                size_t common = prefix.size();
+                while (common < options.front().size() && common < options.back().size() &&
+                    options.front()[common] == options.back()[common]) {
+                    ++common;
+                }
+                extension = options.front().substr(prefix.size(), common - prefix.size());
+            }
+            if (options.size() > MaxCompletions) {
+                options.resize(MaxCompletions);
+            }
+        }
+        if (total == 0) {
+            return false;
+        }
+
+        //    ,  -  
+        std::string value = total == 1 ? options.front() : std::string(prefix) + extension;
+        //           
+        bool needsQuote = quoted || value.find_first_of(" \t") != std::string::npos;
+        completed.assign(input.data(), tokenStart);
+        if (total == 1) {
+            //    - .   
+            // (    )   
+            bool directory = !value.empty() && (value.back() == '/' || value.back() == '\\');
+            if (needsQuote) {
+                completed += '"' + value + (directory ? "" : "\"");
+            }
+            else {
+                completed += value;
+            }
+            if (!directory) {
+                completed += ' ';
+            }
+            options.clear();
+        }
+        else {
+            //  ,   :    
+            completed += needsQuote ? '"' + value : value;
+        }
+        return true;
     }
-};
 
-//     
-class CommandArgs {
-private:
-    std::vector<std::string> args;
+    //     :  
+    //    callback,     argNames
+    // ( )    .    - CancelToken,
+    //    
+    template <typename Callback,
+        typename = std::enable_if_t<!std::is_invocable<Callback&, const CommandArgs&>::value>>
+    void registerCommand(const std::string& name, Callback callback, const std::string& description,
+        std::initializer_list<const char*> argNames = {}) {
+        using Signature = CommandSignature<Callback>;
+        std::string usage = Signature::usage(name, argNames);
+        std::vector<std::string> paramNames;
+        for (size_t i = 0; i < argNames.size(); ++i) {
+            paramNames.push_back(argNames.begin()[i]);
+        }
 
-public:
-    CommandArgs(const std::vector<std::string>& args) : args(args) {}
+        registerCommand(name, [this, name, usage, paramNames, callback](const CommandArgs& args) {
+            typename Signature::Error error;
+            typename Signature::Tuple values;
+            if (Signature::parse(args, values, error)) {
+                if constexpr (Signature::isAsync()) {
+                    std::string command = name;
+                    for (std::string_view arg : args) {
+                        command += ' ';
+                        command.append(arg.data(), arg.size());
+                    }
+                    startJob(command, [callback, values](const CancelToken& token) mutable {
+                        Signature::call(callback, std::move(values), token);
+                        });
+                }
+                else {
+                    Signature::call(callback, std::move(values));
+                }
+                return;
+            }
+            std::string message;
+            if (error.kind == Signature::Error::Invalid) {
+                std::string param = error.index < paramNames.size() ? paramNames[error.index] : std::to_string(error.index + 1);
+                message = u8":  '" + param + u8"'  '" + name + u8"'  : " +
+                    Signature::typeLabel(error.index) + u8" ( '" + args.getArg(error.index) + "')";
+            }
+            else {
+                message = (error.kind == Signature::Error::Missing ? u8":  . " :
+                    u8":  . ") + std::string(u8": ") + usage;
+            }
+            logger->log(LogLevel::Error, message);
+            logger->setStatusMessage(message);
+            }, (description.empty() ? usage : description + ": " + usage) + (Signature::isAsync() ? u8" ( )" : ""));
+    }
 
-    //    
-    std::string getArg(size_t index) const {
-        if (index < args.size()) {
-            return args[index];
+    //   ;        
+    bool startJob(const std::string& command, CommandJobs::Work work) {
+        uint32_t id = 0;
+        std::string error;
+        if (!jobs.submit(command, std::move(work), id, error)) {
+            logger->log(LogLevel::Error, u8":  '" + command + u8"'  : " + error);
+            return false;
         }
-        return "";
+        logger->setStatusMessage(u8" " + std::to_string(id) + u8" : " + command);
+        return true;
     }
 
-    //   
-    const std::vector<std::string>& getArgs() const {
-        return args;
+    //     
+    std::vector<CommandJobs::JobInfo> listJobs() {
+        return jobs.list();
     }
 
-    //   
-    size_t count() const {
-        return args.size();
+    //    
+    bool cancelJob(uint32_t id) {
+        return jobs.cancel(id);
     }
-};
-
-//    
-class CommandProcessor {
-private:
-    using CommandFunction = std::function<void(const CommandArgs&)>;
-    std::map<std::string, CommandFunction> commands;
-    std::map<std::string, std::string> commandDescriptions;
-    std::shared_ptr<Logger> logger;
 
-public:
-    CommandProcessor(std::shared_ptr<Logger> logger) : logger(logger) {}
+    //      (   )
+    void collectJobs() {
+        CommandJobs::Finished job;
+        while (jobs.poll(job)) {
+            char seconds[32];
+            snprintf(seconds, sizeof(seconds), "%.1f", job.seconds);
+            std::string message = u8" " + std::to_string(job.id) + " (" + job.command + ") " +
+                (!job.error.empty() ? u8"  : " + job.error :
+                    job.cancelled ? u8"" : u8"") + u8"  " + seconds + u8" ";
+            logger->log(job.error.empty() ? LogLevel::Info : LogLevel::Error, message);
+            logger->setStatusMessage(message);
+        }
+    }
 
-    //   
-    void registerCommand(const std::string& name, CommandFunction callback, const std::string& description = "") {
-        commands[name] = callback;
-        commandDescriptions[name] = description;
+    //       
+    void stopJobs() {
+        jobs.stop();
     }
 
     //  
-    bool executeCommand(const std::string& commandLine) {
-        std::vector<std::string> tokens;
-        std::string token;
-        std::istringstream tokenStream(commandLine);
-
-        //     
-        while (std::getline(tokenStream, token, ' ')) {
-            if (!token.empty()) {
-                tokens.push_back(token);
-            }
+    bool executeCommand(std::string_view commandLine) {
+        //     line,   -  
+        CommandLine line;
+        const char* error = nullptr;
+        if (!line.parse(commandLine, error)) {
+            logger->log(LogLevel::Error, std::string(u8": ") + error);
+            return false;
         }
-
-        if (tokens.empty()) {
+        if (line.empty()) {
             return false;
         }
 
-        std::string commandName = tokens[0];
-        tokens.erase(tokens.begin());
-        CommandArgs args(tokens);
-
         //   
+        std::string_view commandName = line.name();
         auto it = commands.find(commandName);
-        if (it != commands.end()) {
-            logger->setStatusMessage(u8" : " + commandName);
+        if (line.stages() == 1 && it != commands.end()) {
+            logger->setStatusMessage(u8" : " + it->first);
 
-            it->second(args);
+            it->second(line.args());
             return true;
         }
+        else if (line.stages() > 1 || streamCommands.find(commandName) != streamCommands.end()) {
+            std::vector<CommandPipeline::Stage> stages;
+            std::string message;
+            if (!resolvePipeline(line, stages, message)) {
+                logger->log(LogLevel::Error, u8": " + message);
+                return false;
+            }
+            return startPipeline(std::string(commandLine), std::move(stages));
+        }
         else {
-            logger->log(u8":  '" + commandName + u8"'  ");
+            logger->log(LogLevel::Error, u8":  '" + std::string(commandName) + u8"'  ");
             return false;
         }
     }
 
+    //        
+    bool resolvePipeline(const CommandLine& line, std::vector<CommandPipeline::Stage>& stages, std::string& error) const {
+        stages.resize(line.stages());
+        for (size_t i = 0; i < stages.size(); ++i) {
+            std::string_view name = line.stageName(i);
+            auto it = streamCommands.find(name);
+            if (it == streamCommands.end()) {
+                error = u8" '" + std::string(name) + (commands.find(name) != commands.end() ?
+                    u8"'     " : u8"'  ");
+                return false;
+            }
+            stages[i].function = it->second;
+            for (std::string_view arg : line.stageArgs(i)) {
+                stages[i].args.emplace_back(arg);
+            }
+        }
+        return true;
+    }
+
+    //    .   , 
+    //   ;         
+    bool startPipeline(const std::string& command, std::vector<CommandPipeline::Stage> stages) {
+        std::shared_ptr<Logger> output = logger;
+        return startJob(command, [output, stages](const CancelToken& token) {
+            LineBatcher batcher(output, Logger::ConsoleChannel);
+            LineWriter writer(batcher, token);
+            CommandPipeline::run(stages, writer, token);
+            });
+    }
+
+    //        .  
+    //    '#'   .      ,
+    //   . ,   , 
+    //    
+    bool startScript(const std::string& path) {
+        if (scripts.size() >= MaxScriptDepth) {
+            logger->log(LogLevel::Error, u8":    : " + path);
+            return false;
+        }
+        std::string content;
+        std::string error;
+        if (!CommandScript::readFile(path, content, error)) {
+            logger->log(LogLevel::Error, u8"    'source': " + error);
+            logger->setStatusMessage(u8": " + error);
+            return false;
+        }
+
+        std::unique_ptr<CommandScript> script(new CommandScript(path));
+        CommandLine line;
+        size_t errors = 0;
+        uint32_t lineNumber = 0;
+        const char* p = content.data();
+        const char* end = p + content.size();
+        while (p < end) {
+            const char* newline = static_cast<const char*>(memchr(p, '\n', static_cast<size_t>(end - p)));
+            const char* lineEnd = newline ? newline : end;
+            std::string_view text(p, static_cast<size_t>(lineEnd - p));
+            p = newline ? newline + 1 : end;
+            ++lineNumber;
+
+            size_t first = text.find_first_not_of(" \t\r");
+            if (first == std::string_view::npos || text[first] == '#') {
+                continue;
+            }
+            const char* parseError = nullptr;
+            std::string message;
+            if (!line.parse(text, parseError)) {
+                message = parseError;
+            }
+            else if (line.stages() == 1 && commands.find(line.name()) != commands.end()) {
+                script->addCommand(&commands.find(line.name())->second, line.args(), lineNumber);
+                continue;
+            }
+            else if (line.stages() == 1 && streamCommands.find(line.name()) == streamCommands.end()) {
+                message = u8" '" + std::string(line.name()) + u8"'  ";
+            }
+            else {
+                CommandScript::Pipeline pipeline;
+                if (resolvePipeline(line, pipeline.stages, message)) {
+                    pipeline.command.assign(text.data(), text.size());
+                    script->addPipeline(std::move(pipeline), lineNumber);
+                    continue;
+                }
+            }
+            if (++errors <= MaxScriptErrors) {
+                logger->log(LogLevel::Error, u8": " + path + ":" + std::to_string(lineNumber) + ": " + message);
+            }
+        }
+        if (errors > 0) {
+            std::string message = u8" " + path + u8"  :  - " + std::to_string(errors);
+            logger->log(LogLevel::Error, u8": " + message);
+            logger->setStatusMessage(u8": " + message);
+            return false;
+        }
+
+        script->finish();
+        logger->setStatusMessage(u8" : " + path + " (" + std::to_string(script->size()) + u8" )");
+        scripts.push_back(std::move(script));
+        return true;
+    }
+
+    //       budget (   )
+    void runScripts(std::chrono::microseconds budget) {
+        std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + budget;
+        bool executed = false;
+        while (!scripts.empty()) {
+            CommandScript& script = *scripts.back();
+            if (script.done()) {
+                logger->setStatusMessage(u8" : " + script.getPath());
+                scripts.pop_back();
+                continue;
+            }
+            //     :   (, load  save)
+            //    .        
+            if (executed && std::chrono::steady_clock::now() >= deadline) {
+                return;
+            }
+            executed = true;
+            const CommandScript::Instruction& instruction = script.next();
+            if (instruction.function) {
+                (*instruction.function)(script.argsOf(instruction));
+            }
+            else {
+                const CommandScript::Pipeline& pipeline = script.pipelineOf(instruction);
+                startPipeline(pipeline.command, pipeline.stages);
+            }
+        }
+    }
+
+    //  ,    
+    const std::vector<std::unique_ptr<CommandScript>>& getScripts() const {
+        return scripts;
+    }
+
+    //   
+    void stopScripts() {
+        if (!scripts.empty()) {
+            logger->setStatusMessage(u8" : " + scripts.front()->getPath());
+            scripts.clear();
+        }
+    }
+
     //      
     const std::map<std::string, std::string>& getCommandHelp() const {
         return commandDescriptions;
@@ -161,24 +477,80 @@ private:
 
     GLFWwindow* window;
     char commandBuffer[256];
+    bool commandRefocused;              //     
     bool autoScroll;
     //bool showCommandsList;
     //std::string statusMessage;
     //std::chrono::steady_clock::time_point statusTime;
     int historyPos;
-    std::vector<std::string> commandHistory;
+    RingBuffer<std::string> commandHistory;
+    TimestampFormatter timestampFormatter;
+    int minLevel;                       //    
+    int channelFilter;                  //     (LogStore::AnySource - )
+    std::vector<std::string> channelNames;
+    ImGuiTextFilter logFilter;          //   : "aaa,bbb,-ccc"
+    bool wrapLines;                     //    
+    std::vector<float> channelIndents;  //       
+
+    //  :    ,    
+    //    .        
+    struct LogTab {
+        uint32_t pid = 0;                   //   (0 -  )
+        std::string label;
+        std::vector<uint16_t> channels;     //   ( -  )
+        LogView view;
+        WrapLayout wrap;
+        VirtualScroll scroll;
+        uint64_t topId = UINT64_MAX;        //   :       
+    };
+    std::vector<std::unique_ptr<LogTab>> logTabs;
+    LogTab* currentTab;
+
+    static const uint64_t NoLine = UINT64_MAX;
+    static const size_t MaxSearchResults = 100000;
+    static constexpr int SearchDelayMs = 250;   //  ,    
+    char searchBuffer[256];
+    std::string typedQuery;             //        
+    std::chrono::steady_clock::time_point typedTime;
+    std::string searchQuery;            // ,    ( ) searchResults
+    TrigramIndex::Search pendingSearch; // ,     
+    bool searchRunning;
+    std::vector<uint64_t> searchResults;
+    bool searchTruncated;
+    size_t searchCursor;
+    uint64_t highlightId;               //   
+    uint64_t scrollToId;                // ,       
+    std::vector<std::unique_ptr<FileTail>> tails;   // ,     tail
+    std::unique_ptr<StreamReader> stdinReader;      //    (--stdin)
+    std::unique_ptr<ProcessManager> processManager; //    run
+    std::vector<std::unique_ptr<DatagramReceiver>> receivers;   //   listen
 
 public:
     ImGuiUI() :
         running(false),
         window(nullptr),
+        commandRefocused(false),
         autoScroll(true),
         //showCommandsList(false),
-        historyPos(-1) {
+        historyPos(-1),
+        commandHistory(50),
+        minLevel(static_cast<int>(LogLevel::Trace)),
+        channelFilter(LogStore::AnySource),
+        wrapLines(false),
+        currentTab(nullptr),
+        searchRunning(false),
+        searchTruncated(false),
+        searchCursor(0),
+        highlightId(NoLine),
+        scrollToId(NoLine) {
 
         logger = std::make_shared<Logger>();
         processor = std::make_shared<CommandProcessor>(logger);
+        processManager.reset(new ProcessManager(logger));
+        logTabs.emplace_back(new LogTab());
+        currentTab = logTabs[0].get();
         commandBuffer[0] = '\0';
+        searchBuffer[0] = '\0';
         setupCommands();
     }
 
@@ -261,29 +633,561 @@ public:
             }, u8"  ");
 
         // 
-        processor->registerCommand("add", [this](const CommandArgs& args) {
-            if (args.count() < 2) {
-                logger->log(u8":  'add'    ");
-                logger->setStatusMessage(u8":  ");
+        processor->registerCommand("add", [this](int a, int b) {
+            long long result = static_cast<long long>(a) + b;
+
+            std::string message = u8"  " + std::to_string(a) +
+                u8"  " + std::to_string(b) + " = " + std::to_string(result);
+            logger->log(u8""+ message);
+            logger->setStatusMessage(u8"" + message);
+            }, u8"  ", { u8"1", u8"2" });
+
+        // ,  ,     
+        processor->registerCommand("memory", [this](std::optional<size_t> megabytes) {
+            if (megabytes) {
+                logger->setMemoryBudget(*megabytes * 1024 * 1024);
+            }
+
+            const LogStore& logs = logger->getLogs();
+            std::string message = u8": " + std::to_string(logs.size()) +
+                u8",  : " + std::to_string(logs.memoryUsage() / (1024 * 1024)) +
+                u8" ,  : " + std::to_string(logs.packedChunkCount()) +
+                u8",  : " + std::to_string(logs.spilledBytes() / (1024 * 1024)) +
+                u8" , : " + std::to_string(logs.getMemoryBudget() / (1024 * 1024)) + u8" ";
+            logger->log(message);
+            logger->setStatusMessage(message);
+            }, u8" ", { u8"  " });
+
+        //   
+        processor->registerCommand("repeat", [this](std::optional<size_t> newWindow) {
+            if (newWindow) {
+                if (*newWindow > Logger::MaxRepeatWindow) {
+                    logger->log(LogLevel::Error, u8":     " +
+                        std::to_string(Logger::MaxRepeatWindow) + u8" ");
+                    return;
+                }
+                logger->setRepeatWindow(*newWindow);
+            }
+
+            size_t window = logger->getRepeatWindow();
+            std::string message = window == 0 ? u8"  " :
+                window == 1 ? u8"  " :
+                u8"   " + std::to_string(window) + u8"   ";
+            logger->log(message);
+            logger->setStatusMessage(message);
+            }, u8" ", { u8": 0 - , 1 - " });
+
+        //  
+        processor->registerCommand("jobs", [this](const CommandArgs& args) {
+            std::vector<CommandJobs::JobInfo> list = processor->listJobs();
+            if (list.empty()) {
+                logger->log(u8"  ");
+            }
+            for (const CommandJobs::JobInfo& job : list) {
+                char seconds[32];
+                snprintf(seconds, sizeof(seconds), "%.1f", job.seconds);
+                logger->log(std::to_string(job.id) + "  " +
+                    (job.cancelling ? u8"" : job.running ? u8"" : u8"") +
+                    "  " + seconds + u8"   " + job.command);
+            }
+            }, u8"  ");
+
+        processor->registerCommand("kill", [this](uint32_t id) {
+            if (!processor->cancelJob(id)) {
+                logger->log(LogLevel::Error, u8":    " + std::to_string(id));
+                return;
+            }
+            logger->setStatusMessage(u8" " + std::to_string(id) + u8" ");
+            }, u8"  ", { u8"" });
+
+        //   
+        processor->registerCommand("level", [this](std::optional<LogLevel> level) {
+            if (level) {
+                minLevel = static_cast<int>(*level);
+            }
+            logger->setStatusMessage(std::string(u8"    ") +
+                CommandEnum<LogLevel>::names[minLevel]);
+            }, u8"   ");
+
+        //    
+        processor->registerCommand("find", [this](const CommandArgs& args) {
+            std::string query;
+            for (size_t i = 0; i < args.count(); ++i) {
+                query += (i > 0 ? " " : "") + args.getArg(i);
+            }
+            if (query.empty()) {
+                logger->log(LogLevel::Error, u8":  'find'    ");
+                return;
+            }
+
+            snprintf(searchBuffer, sizeof(searchBuffer), "%s", query.c_str());
+            search(query);
+
+            std::string message = u8" : " + std::to_string(searchResults.size()) +
+                (searchTruncated ? "+" : "");
+            logger->log(message);
+            logger->setStatusMessage(message);
+            }, u8"   : find <>");
+
+        //      
+        processor->registerCommand("bench", [this](std::optional<size_t> count, const CancelToken& token) {
+            size_t lines = count.value_or(1000000);
+            if (lines == 0) {
+                logger->log(LogLevel::Error, u8":      ");
+                return;
+            }
+            benchmarkFilter(lines, token);
+            }, u8"   ", { u8"" });
+
+        //    
+        processor->registerCommand("tail", [this](const CommandArgs& args) {
+            if (args.count() == 0) {
+                if (tails.empty()) {
+                    logger->log(u8"   ");
+                }
+                for (const auto& tail : tails) {
+                    logger->log(u8"tail: " + tail->getPath());
+                }
+                return;
+            }
+
+            std::string path = args.getArg(0);
+            for (const auto& tail : tails) {
+                if (tail->getPath() == path) {
+                    logger->log(LogLevel::Error, u8":    : " + path);
+                    return;
+                }
+            }
+            std::unique_ptr<FileTail> tail(new FileTail(logger, path));
+            std::string error;
+            if (!tail->start(error)) {
+                logger->log(LogLevel::Error, u8"    'tail': " + error);
+                logger->setStatusMessage(u8": " + error);
+                return;
+            }
+            tails.push_back(std::move(tail));
+            logger->setStatusMessage(u8"  : " + path);
+            }, u8"   : tail []");
+
+        processor->registerCommand("untail", [this](const std::string& path) {
+            for (auto it = tails.begin(); it != tails.end(); ++it) {
+                if ((*it)->getPath() == path) {
+                    tails.erase(it);
+                    logger->setStatusMessage(u8" : " + path);
+                    return;
+                }
+            }
+            logger->log(LogLevel::Error, u8":    : " + path);
+            }, u8"   ", { u8"" });
+
+        //  :      "cat app.log | grep error | head 20"
+        processor->registerStreamCommand("cat", [](const CommandArgs& args, LineReader&, LineWriter& output, const CancelToken& token) {
+            if (args.count() != 1) {
+                throw std::runtime_error(u8": cat <>");
+            }
+            FileLineSource file;
+            std::string error;
+            if (!file.open(args.getArg(0), error)) {
+                throw std::runtime_error(error);
+            }
+            if (file.readAvailable(output, token)) {
+                file.finish(output);
+            }
+            }, u8"  : cat <>");
+
+        processor->registerStreamCommand("tail", [this](const CommandArgs& args, LineReader&, LineWriter& output, const CancelToken& token) {
+            if (args.count() != 1) {
+                throw std::runtime_error(u8": tail <>");
+            }
+            FileFollower follower(args.getArg(0));
+            std::string error;
+            if (!follower.watch(error)) {
+                throw std::runtime_error(error);
+            }
+            auto notice = [this](LogLevel level, const std::string& message) {
+                logger->log(level, message);
+            };
+            //  ,   ,        .
+            //     ,    
+            LineTextSink sink(output);
+            follower.skipToTail(FileTail::InitialBytes);
+            follower.readAppended(sink, notice);
+            while (sink.flush() && !token.cancelled()) {
+                FileFollower::Wait result = follower.waitForChanges(200);
+                if (result == FileFollower::Wait::Stopped) {
+                    break;
+                }
+                if (result == FileFollower::Wait::Changed) {
+                    follower.readAppended(sink, notice);
+                }
+            }
+            }, u8"      : tail <>");
+
+        processor->registerStreamCommand("grep", [](const CommandArgs& args, LineReader& input, LineWriter& output, const CancelToken&) {
+            bool invert = args.count() > 0 && args.view(0) == "-v";
+            size_t first = invert ? 1 : 0;
+            if (args.count() <= first) {
+                throw std::runtime_error(u8": grep [-v] <>");
+            }
+            std::string needle;
+            for (size_t i = first; i < args.count(); ++i) {
+                if (i > first) {
+                    needle += ' ';
+                }
+                for (char c : args.view(i)) {
+                    needle += TextMatch::fold(c);
+                }
+            }
+            std::string_view line;
+            while (input.next(line)) {
+                bool found = TextMatch::find(line.data(), line.data() + line.size(), needle.data(), needle.size()) != nullptr;
+                if (found != invert && !output.write(line)) {
+                    return;
+                }
+            }
+            }, u8"    (  ), -v -  : grep [-v] <>");
+
+        processor->registerStreamCommand("head", [](const CommandArgs& args, LineReader& input, LineWriter& output, const CancelToken&) {
+            size_t limit = 10;
+            if (args.count() > 1 || (args.count() == 1 && !CommandArg<size_t>::parse(args.view(0), limit))) {
+                throw std::runtime_error(u8": head []");
+            }
+            //    ,     
+            std::string_view line;
+            for (size_t i = 0; i < limit && input.next(line); ++i) {
+                if (!output.write(line)) {
+                    return;
+                }
+            }
+            }, u8"   (  10): head []");
+
+        processor->registerStreamCommand("count", [](const CommandArgs& args, LineReader& input, LineWriter& output, const CancelToken& token) {
+            uint64_t lines = 0;
+            std::string_view line;
+            while (input.next(line)) {
+                ++lines;
+            }
+            if (!token.cancelled()) {
+                output.write(u8": " + std::to_string(lines));
+            }
+            }, u8" : count");
+
+        //  
+        processor->registerCommand("run", [this](const CommandArgs& args) {
+            if (args.count() == 0) {
+                logger->log(LogLevel::Error, u8":  'run'    ");
+                return;
+            }
+            std::vector<std::string> arguments;
+            for (size_t i = 0; i < args.count(); ++i) {
+                arguments.push_back(args.getArg(i));
+            }
+            uint32_t pid = 0;
+            std::string error;
+            if (!processManager->run(arguments, pid, error)) {
+                logger->log(LogLevel::Error, u8"    'run': " + error);
+                logger->setStatusMessage(u8": " + error);
                 return;
             }
+            logger->setStatusMessage(u8"  " + std::to_string(pid));
+            }, u8"     : run <> []");
 
+        processor->registerCommand("ps", [this](const CommandArgs& args) {
+            std::vector<ProcessInfo> list = processManager->list();
+            if (list.empty()) {
+                logger->log(u8"  ");
+            }
+            for (const ProcessInfo& process : list) {
+                logger->log(std::to_string(process.pid) + "  " +
+                    (process.running ? u8"" : u8" (" + std::to_string(process.exitCode) + ")") +
+                    "  " + process.command);
+            }
+            }, u8"  ");
+
+        processor->registerCommand("stop", [this](uint32_t pid) {
+            if (!processManager->terminate(pid)) {
+                logger->log(LogLevel::Error, u8":    " + std::to_string(pid));
+                return;
+            }
+            logger->setStatusMessage(u8" " + std::to_string(pid) + u8" ");
+            }, u8" ", { "pid" });
+
+        //    
+        processor->registerCommand("listen", [this](const CommandArgs& args) {
+            if (args.count() == 0) {
+                if (receivers.empty()) {
+                    logger->log(u8"  ");
+                }
+                for (const auto& receiver : receivers) {
+                    logger->log(u8"listen: " + receiver->getName());
+                }
+                return;
+            }
+
+            std::unique_ptr<DatagramReceiver> receiver(new DatagramReceiver(logger));
+            std::string error;
+            bool started = false;
+            if (args.getArg(0) == "unix") {
+                if (args.count() < 2) {
+                    logger->log(LogLevel::Error, u8":  'listen unix'    ");
+                    return;
+                }
+                for (const auto& existing : receivers) {
+                    if (existing->getName() == "unix:" + args.getArg(1)) {
+                        logger->log(LogLevel::Error, u8":   : " + existing->getName());
+                        return;
+                    }
+                }
+                started = receiver->listenUnix(args.getArg(1), error);
+            }
+            else {
+                uint16_t port = 0;
+                if (!CommandArg<uint16_t>::parse(args.view(0), port) || port == 0) {
+                    logger->log(LogLevel::Error, u8":  ''  'listen'  :   1  65535  unix ( '" +
+                        args.getArg(0) + "')");
+                    return;
+                }
+                started = receiver->listenUdp(port, error);
+            }
+            if (!started) {
+                logger->log(LogLevel::Error, u8"    'listen': " + error);
+                logger->setStatusMessage(u8": " + error);
+                return;
+            }
+            logger->setStatusMessage(u8" : " + receiver->getName());
+            receivers.push_back(std::move(receiver));
+            }, u8"  : listen [ | unix <>]");
+
+        processor->registerCommand("unlisten", [this](const std::string& name) {
+            for (auto it = receivers.begin(); it != receivers.end(); ++it) {
+                if ((*it)->getName() == name) {
+                    receivers.erase(it);
+                    logger->setStatusMessage(u8" : " + name);
+                    return;
+                }
+            }
+            logger->log(LogLevel::Error, u8":   : " + name);
+            }, u8"  ", { u8" (udp:  unix:)" });
+
+        //  
+        processor->registerCommand("source", [this](const std::string& path) {
+            processor->startScript(path);
+            }, u8"    (    )", { u8"" });
+
+        //  
+        processor->registerCommand("save", [this](const std::string& path) {
+            auto start = std::chrono::steady_clock::now();
+            std::string error;
+            if (!logger->saveSession(path, error)) {
+                logger->log(LogLevel::Error, u8"    'save': " + error);
+                logger->setStatusMessage(u8": " + error);
+                return;
+            }
+            double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            char message[256];
+            snprintf(message, sizeof(message), u8" : %zu   %.1f ", logger->getLogs().size(), ms);
+            logger->log(message);
+            logger->setStatusMessage(message);
+            }, u8"    ", { u8"" });
+
+        processor->registerCommand("load", [this](const std::string& path) {
+            auto start = std::chrono::steady_clock::now();
+            std::string error;
+            if (!logger->loadSession(path, error)) {
+                logger->log(LogLevel::Error, u8"    'load': " + error);
+                logger->setStatusMessage(u8": " + error);
+                return;
+            }
+            //      
+            if (searchRunning) {
+                startSearch(searchQuery);
+            }
+            double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            char message[256];
+            snprintf(message, sizeof(message), u8" : %zu   %.1f ", logger->getLogs().size(), ms);
+            logger->setStatusMessage(message);
+            }, u8"     ", { u8"" });
+
+        //    Tab
+        auto firstPath = [](size_t index, std::string_view prefix, std::vector<std::string>& candidates) {
+            if (index == 0) {
+                completePath(prefix, candidates);
+            }
+        };
+        for (const char* name : { "tail", "cat", "source", "save", "load" }) {
+            processor->setCompleter(name, firstPath);
+        }
+        processor->setCompleter("untail", [this](size_t, std::string_view, std::vector<std::string>& candidates) {
+            for (const auto& tail : tails) {
+                candidates.push_back(tail->getPath());
+            }
+            });
+        processor->setCompleter("listen", [](size_t index, std::string_view prefix, std::vector<std::string>& candidates) {
+            if (index == 0) {
+                candidates.push_back("unix");
+            }
+            else if (index == 1) {
+                completePath(prefix, candidates);
+            }
+            });
+        processor->setCompleter("unlisten", [this](size_t, std::string_view, std::vector<std::string>& candidates) {
+            for (const auto& receiver : receivers) {
+                candidates.push_back(receiver->getName());
+            }
+            });
+        processor->setCompleter("stop", [this](size_t, std::string_view, std::vector<std::string>& candidates) {
+            for (const ProcessInfo& process : processManager->list()) {
+                if (process.running) {
+                    candidates.push_back(std::to_string(process.pid));
+                }
+            }
+            });
+        processor->setCompleter("kill", [this](size_t, std::string_view, std::vector<std::string>& candidates) {
+            for (const CommandJobs::JobInfo& job : processor->listJobs()) {
+                candidates.push_back(std::to_string(job.id));
+            }
+            });
+        processor->setCompleter("level", [](size_t, std::string_view, std::vector<std::string>& candidates) {
+            for (const char* name : CommandEnum<LogLevel>::names) {
+                candidates.push_back(name);
+            }
+            });
+    }
+
+    //    :    prefix,   
+    //   prefix.    ,   
+    static void completePath(std::string_view prefix, std::vector<std::string>& candidates) {
+        static const size_t MaxEntries = 10000;
+        size_t slash = prefix.find_last_of("/\\");
+        std::string directory(prefix.substr(0, slash == std::string_view::npos ? 0 : slash + 1));
+        std::string_view namePrefix = prefix.substr(directory.size());
+        char separator = slash == std::string_view::npos ? '/' : prefix[slash];
+
+        std::error_code error;
+        std::filesystem::directory_iterator it(directory.empty() ? std::string(".") : directory, error);
+        size_t entries = 0;
+        for (; !error && it != std::filesystem::directory_iterator() && entries < MaxEntries; it.increment(error), ++entries) {
+            std::string name;
             try {
-                int a = std::stoi(args.getArg(0));
-                int b = std::stoi(args.getArg(1));
-                int result = a + b;
+                name = it->path().filename().string();
+            }
+            catch (const std::exception&) {
+                continue;       //       
+            }
+            if (name.compare(0, namePrefix.size(), namePrefix.data(), namePrefix.size()) != 0) {
+                continue;
+            }
+            std::error_code typeError;
+            candidates.push_back(directory + name + (it->is_directory(typeError) ? std::string(1, separator) : std::string()));
+        }
+    }
 
-                std::string message = u8"  " + std::to_string(a) +
-                    u8"  " + std::to_string(b) + " = " + std::to_string(result);
-                logger->log(u8""+ message);
-                logger->setStatusMessage(u8"" + message);
+    //        ;   
+    void renderJobs() {
+        std::vector<CommandJobs::JobInfo> list = processor->listJobs();
+        const auto& scripts = processor->getScripts();
+        if (list.empty() && scripts.empty()) {
+            return;
+        }
+        std::vector<std::string> labels;
+        float width = 0;
+        if (!scripts.empty()) {
+            //    ; "x"  
+            const CommandScript& script = *scripts.back();
+            char label[160];
+            snprintf(label, sizeof(label), "%.40s %zu/%zu", script.getPath().c_str(), script.executed(), script.size());
+            labels.push_back(label);
+            width += ImGui::CalcTextSize(label).x + ImGui::GetFrameHeight() + 3 * ImGui::GetStyle().ItemSpacing.x;
+        }
+        for (const CommandJobs::JobInfo& job : list) {
+            char label[128];
+            snprintf(label, sizeof(label), "#%u %.40s %.0f%s", job.id, job.command.c_str(), job.seconds, u8" ");
+            labels.push_back(label);
+            width += ImGui::CalcTextSize(label).x + ImGui::GetFrameHeight() + 3 * ImGui::GetStyle().ItemSpacing.x;
+        }
+        ImGui::SameLine(std::max(ImGui::GetWindowContentRegionMax().x - width, ImGui::GetCursorPosX()));
+        size_t firstJob = 0;
+        if (!scripts.empty()) {
+            ImGui::PushID("scripts");
+            ImGui::TextDisabled("%s", labels[0].c_str());
+            ImGui::SameLine();
+            if (ImGui::SmallButton("x")) {
+                processor->stopScripts();
             }
-            catch (std::exception& e) {
-                std::string errorMsg = u8"    'add': " + std::string(e.what());
-                logger->log(errorMsg);
-                logger->setStatusMessage(errorMsg);
+            ImGui::PopID();
+            ImGui::SameLine();
+            firstJob = 1;
+        }
+        for (size_t i = 0; i < list.size(); ++i) {
+            ImGui::PushID(static_cast<int>(list[i].id));
+            ImGui::TextDisabled("%s", labels[firstJob + i].c_str());
+            ImGui::SameLine();
+            if (!list[i].cancelling && ImGui::SmallButton("x")) {
+                processor->cancelJob(list[i].id);
             }
-            }, u8"  : add <1> <2>");
+            ImGui::PopID();
+            ImGui::SameLine();
+        }
+        ImGui::NewLine();
+    }
+
+    //          
+    // (  ,     )
+    void benchmarkFilter(size_t lines, const CancelToken& token) {
+        LogStore store(lines, 0);
+        static const char* words[] = { "request", "worker", "cache", "session", "upload", "timeout", "retry", "socket" };
+        char text[128];
+        uint32_t seed = 12345;
+        size_t bytes = 0;
+        for (size_t i = 0; i < lines; ++i) {
+            seed = seed * 1664525 + 1013904223;
+            int length = snprintf(text, sizeof(text), "worker %u processed %s %u in %u ms status=%s",
+                (seed >> 8) % 64, words[(seed >> 4) % 8], seed % 100000, (seed >> 12) % 1000,
+                (seed >> 20) % 1000 == 0 ? "ERROR" : "ok");
+            store.append(0, static_cast<uint8_t>(LogLevel::Info), Logger::ConsoleChannel, text, static_cast<size_t>(length));
+            bytes += static_cast<size_t>(length);
+            if ((i & 0xFFFF) == 0 && token.cancelled()) {
+                return;
+            }
+        }
+
+        static const char* patterns[] = { "status=error", "timeout", "cache,upload,-retry", "k" };
+        std::vector<uint8_t> passes;
+        for (const char* pattern : patterns) {
+            if (token.cancelled()) {
+                return;
+            }
+            TextFilter filter;
+            filter.parse(pattern);
+
+            size_t vectorMatches = 0;
+            auto start = std::chrono::steady_clock::now();
+            store.scanChunks(store.firstId(), store.endId(), [&](const LogStore::ChunkColumns& columns, size_t pos, size_t end) {
+                passes.resize(end - pos);
+                filter.matchLines(columns, pos, end, passes.data());
+                vectorMatches += static_cast<size_t>(std::count(passes.begin(), passes.end(), 1));
+                return true;
+                });
+            auto middle = std::chrono::steady_clock::now();
+
+            size_t scalarMatches = 0;
+            store.scanChunks(store.firstId(), store.endId(), [&](const LogStore::ChunkColumns& columns, size_t pos, size_t end) {
+                passes.resize(end - pos);
+                filter.matchLinesScalar(columns, pos, end, passes.data());
+                scalarMatches += static_cast<size_t>(std::count(passes.begin(), passes.end(), 1));
+                return true;
+                });
+            auto finish = std::chrono::steady_clock::now();
+
+            double vectorMs = std::chrono::duration<double, std::milli>(middle - start).count();
+            double scalarMs = std::chrono::duration<double, std::milli>(finish - middle).count();
+            char message[256];
+            snprintf(message, sizeof(message), u8"'%s': %s %.1f  (%.0f /),  %.1f , x%.1f,  %zu%s",
+                pattern, TextMatch::implementationName(), vectorMs, bytes / (1024.0 * 1024.0) / (vectorMs / 1000.0),
+                scalarMs, scalarMs / std::max(vectorMs, 0.001), vectorMatches,
+                vectorMatches == scalarMatches ? "" : u8" ()");
+            logger->log(message);
+        }
     }
 
     //   
@@ -298,6 +1202,13 @@ public:
         glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT);
 
+        //    ,    .
+        //   ,   ,    
+        logger->drain(std::chrono::microseconds(8000));
+        processor->collectJobs();
+        processor->runScripts(std::chrono::microseconds(4000));
+        continueSearch(std::chrono::steady_clock::now() + std::chrono::microseconds(4000));
+
         //    ImGui
         ImGui_ImplOpenGL3_NewFrame();
         ImGui_ImplGlfw_NewFrame();
@@ -312,28 +1223,73 @@ public:
             ImGuiWindowFlags_NoMove |
             ImGuiWindowFlags_NoCollapse);
 
+        //    
+        renderFilterBar();
+
+        //   (,      )
+        bool tabsShown = renderLogTabs();
+
         //     (  )
         float commandHeight = 80.0f;
         float statusHeight = 28.0f;
         ImVec2 logSize = ImVec2(ImGui::GetWindowContentRegionWidth(),
-            ImGui::GetWindowHeight() - commandHeight - statusHeight - 25);
+            ImGui::GetWindowHeight() - commandHeight - statusHeight - (tabsShown ? 3 : 2) * ImGui::GetFrameHeightWithSpacing() - 25);
 
-        ImGui::BeginChild("LogArea", logSize, true, ImGuiWindowFlags_HorizontalScrollbar);
+        //      
+        ImGui::PushID(static_cast<int>(currentTab->pid));
+        //    VirtualScroll
+        ImGui::BeginChild("LogArea", logSize, true,
+            ImGuiWindowFlags_NoScrollWithMouse | (wrapLines ? 0 : ImGuiWindowFlags_HorizontalScrollbar));
 
 
-        //   
+        //  ,   (     ,
+        //  -        4   ).
+        //    ,    
         ImGui::PushStyleVar(ImGuiStyleVar_ItemSpacing, ImVec2(4, 1)); //    
-        for (const auto& log : logger->getLogs()) {
-            ImGui::TextUnformatted(log.c_str());
+        const LogStore& logs = logger->getLogs();
+        updateViews(logs);
+        LogView& logView = currentTab->view;
+        VirtualScroll& scroll = currentTab->scroll;
+
+        //       ,      
+        size_t topRow = 0;
+        if (!scroll.isAtEnd() && logView.rowOf(logs, currentTab->topId, topRow)) {
+            scroll.setTopLine(topRow);
         }
-        ImGui::PopStyleVar();
-        
-        // -
-        if (autoScroll && ImGui::GetScrollY() >= ImGui::GetScrollMaxY()) {
-            ImGui::SetScrollHereY(1.0f);
+
+        //     (  )
+        size_t targetRow = 0;
+        if (scrollToId != NoLine && logView.rowOf(logs, scrollToId, targetRow)) {
+            scroll.scrollTo(targetRow);
+        }
+        scrollToId = NoLine;
+
+        float lineHeight = ImGui::GetTextLineHeightWithSpacing();
+        size_t lineCount = logView.size(logs);
+        if (wrapLines) {
+            renderWrappedLogs(logs);
+        }
+        else {
+            scroll.update(lineCount, lineHeight, autoScroll, [](size_t) { return static_cast<size_t>(1); });
+            size_t line = scroll.getTop().line;
+            for (size_t row = 0; row < scroll.getDrawRows() && line < lineCount; ++row, ++line) {
+                scroll.placeRow(row);
+                uint64_t id = logView.idAt(logs, line);
+                if (id == highlightId) {
+                    highlightRows(1);
+                }
+                const ColorSpan* spans = nullptr;
+                size_t spanCount = logs.spansOf(id, spans);
+                renderLogLine(logs.line(id), spans, spanCount);
+                renderRepeat(logs, id);
+            }
+            scroll.finish();
         }
+        currentTab->topId = lineCount > 0 ? logView.idAt(logs, scroll.getTop().line) : NoLine;
+        ImGui::PopStyleVar();
 
         ImGui::EndChild();
+        ImGui::PopID();
 
         //  
         ImGui::BeginChild("StatusArea", ImVec2(ImGui::GetWindowContentRegionWidth(), statusHeight), true);
@@ -345,6 +1301,7 @@ public:
         if (!logger->statusMessage.empty() && elapsed < 5) {
             ImGui::TextUnformatted(logger->statusMessage.c_str());
         }
+        renderJobs();
 
         ImGui::EndChild();
 
@@ -352,13 +1309,19 @@ public:
         ImGui::BeginChild("CommandArea", ImVec2(ImGui::GetWindowContentRegionWidth(), commandHeight), true);
         ImGui::Text(u8" :");
 
-        //    
-        ImGui::SetKeyboardFocusHere();
+        //    ,      :
+        //           
+        if (!ImGui::IsAnyItemActive()) {
+            ImGui::SetKeyboardFocusHere();
+            commandRefocused = true;
+        }
 
         //       Enter
         if (ImGui::InputText("##CommandInput", commandBuffer, IM_ARRAYSIZE(commandBuffer),
             ImGuiInputTextFlags_EnterReturnsTrue |
-            ImGuiInputTextFlags_CallbackHistory,
+            ImGuiInputTextFlags_CallbackHistory |
+            ImGuiInputTextFlags_CallbackCompletion |
+            ImGuiInputTextFlags_CallbackAlways,
             [](ImGuiInputTextCallbackData* data) -> int {
                 ImGuiUI* ui = static_cast<ImGuiUI*>(data->UserData);
                 return ui->inputTextCallback(data);
@@ -367,10 +1330,7 @@ public:
             std::string command = commandBuffer;
             if (!command.empty()) {
                 //    
-                commandHistory.push_back(command);
-                if (commandHistory.size() > 50) {  //   
-                    commandHistory.erase(commandHistory.begin());
-                }
+                commandHistory.push_back(command);  //     
                 historyPos = -1;  //    
 
                 //  
@@ -418,8 +1378,419 @@ public:
         ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
     }
 
-    //     
+    //   ,      
+    void renderFilterBar() {
+        static const char* levelNames[] = { "Trace", "Debug", "Info", "Warning", "Error" };
+        ImGui::SetNextItemWidth(120);
+        ImGui::Combo(u8"", &minLevel, levelNames, IM_ARRAYSIZE(levelNames));
+
+        //        
+        size_t channelCount = logger->getChannelCount();
+        for (size_t i = channelNames.size(); i < channelCount; ++i) {
+            channelNames.push_back(logger->getChannelName(static_cast<uint16_t>(i)));
+        }
+
+        ImGui::SameLine();
+        ImGui::SetNextItemWidth(160);
+        const char* preview = channelFilter == LogStore::AnySource ? u8"" : channelNames[channelFilter].c_str();
+        if (ImGui::BeginCombo(u8"", preview)) {
+            if (ImGui::Selectable(u8"", channelFilter == LogStore::AnySource)) {
+                channelFilter = LogStore::AnySource;
+            }
+            for (size_t i = 0; i < channelNames.size(); ++i) {
+                if (ImGui::Selectable(channelNames[i].c_str(), channelFilter == static_cast<int>(i))) {
+                    channelFilter = static_cast<int>(i);
+                }
+            }
+            ImGui::EndCombo();
+        }
+
+        ImGui::SameLine();
+        ImGui::Checkbox(u8" ", &wrapLines);
+
+        //   :        ,  -  Enter
+        ImGui::SameLine();
+        ImGui::SetNextItemWidth(180);
+        bool submitted = ImGui::InputTextWithHint("##Search", u8"", searchBuffer, IM_ARRAYSIZE(searchBuffer),
+            ImGuiInputTextFlags_EnterReturnsTrue);
+        std::string query = searchBuffer;
+        auto now = std::chrono::steady_clock::now();
+        if (query != typedQuery) {
+            typedQuery = query;
+            typedTime = now;
+        }
+        if (submitted || (query != searchQuery && query.size() >= 3 &&
+            now - typedTime >= std::chrono::milliseconds(SearchDelayMs))) {
+            startSearch(query);
+        }
+
+        if (!searchResults.empty()) {
+            ImGui::SameLine();
+            if (ImGui::ArrowButton("##SearchPrev", ImGuiDir_Up)) {
+                selectSearchResult(searchCursor > 0 ? searchCursor - 1 : searchResults.size() - 1);
+            }
+            ImGui::SameLine();
+            if (ImGui::ArrowButton("##SearchNext", ImGuiDir_Down)) {
+                selectSearchResult(searchCursor + 1 < searchResults.size() ? searchCursor + 1 : 0);
+            }
+            ImGui::SameLine();
+            ImGui::Text("%zu/%zu%s", searchCursor + 1, searchResults.size(), searchTruncated ? "+" : "");
+        }
+        else if (searchRunning) {
+            ImGui::SameLine();
+            ImGui::TextDisabled(u8"...");
+        }
+        else if (!searchQuery.empty()) {
+            ImGui::SameLine();
+            ImGui::TextDisabled(u8" ");
+        }
+
+        //  :   , '-'    
+        logFilter.Draw(u8" (,-)", 360);
+        if (!currentTab->view.isComplete(logger->getLogs())) {
+            ImGui::SameLine();
+            ImGui::TextDisabled(u8"...");
+        }
+    }
+
+    //  ""       .  false,   
+    bool renderLogTabs() {
+        std::vector<ProcessInfo> processes = processManager->list();
+        for (size_t i = logTabs.size() - 1; i < processes.size(); ++i) {
+            std::unique_ptr<LogTab> tab(new LogTab());
+            tab->pid = processes[i].pid;
+            tab->label = logger->getChannelName(processes[i].outChannel);
+            tab->channels.push_back(processes[i].outChannel);
+            tab->channels.push_back(processes[i].errChannel);
+            logTabs.push_back(std::move(tab));
+        }
+        if (processes.empty()) {
+            return false;
+        }
+
+        if (ImGui::BeginTabBar("LogTabs", ImGuiTabBarFlags_FittingPolicyScroll)) {
+            if (ImGui::BeginTabItem(u8"")) {
+                currentTab = logTabs[0].get();
+                ImGui::EndTabItem();
+            }
+            for (size_t i = 0; i < processes.size(); ++i) {
+                LogTab* tab = logTabs[i + 1].get();
+                //   ###       
+                std::string label = tab->label + (processes[i].running ? "" :
+                    u8" (" + std::to_string(processes[i].exitCode) + ")") + "###" + std::to_string(tab->pid);
+                if (ImGui::BeginTabItem(label.c_str())) {
+                    currentTab = tab;
+                    ImGui::EndTabItem();
+                }
+            }
+            ImGui::EndTabBar();
+        }
+        return true;
+    }
+
+    //    :     .
+    //        
+    void updateViews(const LogStore& logs) {
+        std::vector<uint16_t> allowed;
+        for (const auto& tab : logTabs) {
+            allowed = tab->channels;
+            if (channelFilter != LogStore::AnySource && (allowed.empty() ||
+                std::find(allowed.begin(), allowed.end(), channelFilter) != allowed.end())) {
+                allowed.assign(1, static_cast<uint16_t>(channelFilter));
+            }
+            tab->view.setFilter(static_cast<uint8_t>(minLevel), allowed, logFilter.InputBuf);
+            tab->view.update(logs, std::chrono::microseconds(tab.get() == currentTab ? 4000 : 500));
+        }
+    }
+
+    //         
+    //  ;       (continueSearch).
+    //      
+    void startSearch(const std::string& query) {
+        searchQuery = query;
+        searchResults.clear();
+        searchTruncated = false;
+        highlightId = NoLine;
+        searchRunning = !query.empty();
+        if (searchRunning) {
+            logger->startSearch(query, MaxSearchResults, pendingSearch);
+        }
+    }
+
+    //    deadline;      
+    void continueSearch(std::chrono::steady_clock::time_point deadline) {
+        if (!searchRunning || !pendingSearch.step(logger->getLogs(), deadline)) {
+            return;
+        }
+        searchRunning = false;
+        searchTruncated = !pendingSearch.isComplete();
+        pendingSearch.takeResults(searchResults);
+        if (!searchResults.empty()) {
+            selectSearchResult(searchResults.size() - 1);
+        }
+    }
+
+    //      ( find)
+    void search(const std::string& query) {
+        startSearch(query);
+        continueSearch(std::chrono::steady_clock::time_point::max());
+    }
+
+    void selectSearchResult(size_t index) {
+        searchCursor = index;
+        highlightId = searchResults[index];
+        scrollToId = highlightId;
+        autoScroll = false;
+    }
+
+    //   ,    
+    void highlightRows(size_t rows) {
+        ImVec2 position = ImGui::GetCursorScreenPos();
+        float height = ImGui::GetTextLineHeightWithSpacing() * rows;
+        ImGui::GetWindowDrawList()->AddRectFilled(position,
+            ImVec2(position.x + ImGui::GetContentRegionAvail().x, position.y + height),
+            ImGui::GetColorU32(ImGuiCol_TextSelectedBg));
+    }
+
+    //     .    , 
+    //   ,   
+    void renderWrappedLogs(const LogStore& logs) {
+        float lineHeight = ImGui::GetTextLineHeightWithSpacing();
+        float timestampWidth = ImGui::CalcTextSize("[00:00:00.000]").x + ImGui::GetStyle().ItemSpacing.x;
+        float textWidth = ImGui::GetContentRegionAvail().x - timestampWidth;
+
+        channelIndents.resize(channelNames.size());
+        for (size_t i = 0; i < channelNames.size(); ++i) {
+            channelIndents[i] = ImGui::CalcTextSize(("[" + channelNames[i] + "]").c_str()).x + ImGui::GetStyle().ItemSpacing.x;
+        }
+
+        LogView& logView = currentTab->view;
+        WrapLayout& wrapLayout = currentTab->wrap;
+        wrapLayout.sync(ImGui::GetFont(), ImGui::GetFontSize(), textWidth);
+        auto indent = [this](const LogLine& line) {
+            return line.source != Logger::ConsoleChannel && line.source < channelIndents.size() ? channelIndents[line.source] : 0.0f;
+        };
+
+        //   ,      
+        VirtualScroll& scroll = currentTab->scroll;
+        size_t lineCount = logView.size(logs);
+        scroll.update(lineCount, lineHeight, autoScroll, [&](size_t line) {
+            const uint32_t* points = nullptr;
+            return wrapLayout.breaksOf(logs, logView.idAt(logs, line), indent, points) + 1;
+            });
+
+        //      :     
+        VirtualScroll::Position top = scroll.getTop();
+        size_t drawRows = scroll.getDrawRows();
+        float textX = ImGui::GetCursorPosX() + timestampWidth;
+        size_t row = 0;
+        for (size_t line = top.line; line < lineCount && row < drawRows; ++line) {
+            uint64_t id = logView.idAt(logs, line);
+            const uint32_t* points = nullptr;
+            size_t breakCount = wrapLayout.breaksOf(logs, id, indent, points);
+            size_t firstRow = line == top.line ? top.row : 0;
+            size_t rowCount = std::min(breakCount + 1 - firstRow, drawRows - row);
+
+            scroll.placeRow(row);
+            if (id == highlightId) {
+                highlightRows(rowCount);
+            }
+            const ColorSpan* spans = nullptr;
+            size_t spanCount = logs.spansOf(id, spans);
+            renderWrappedLogLine(logs.line(id), spans, spanCount, points, breakCount, firstRow, rowCount, textX);
+            if (firstRow + rowCount == breakCount + 1) {
+                renderRepeat(logs, id);
+            }
+            row += rowCount;
+        }
+        scroll.finish();
+    }
+
+    //    [firstRow, firstRow + rowCount)      
+    void renderWrappedLogLine(const LogLine& line, const ColorSpan* spans, size_t spanCount,
+        const uint32_t* points, size_t breakCount, size_t firstRow, size_t rowCount, float textX) {
+        if (firstRow == 0) {
+            char timestamp[TimestampFormatter::MaxLength];
+            size_t length = timestampFormatter.format(line.timestamp, timestamp);
+            ImGui::TextUnformatted(timestamp, timestamp + length);
+            ImGui::SameLine();
+
+            if (line.source != Logger::ConsoleChannel && line.source < channelNames.size()) {
+                ImGui::TextDisabled("[%s]", channelNames[line.source].c_str());
+                ImGui::SameLine();
+            }
+        }
+
+        LogLevel level = static_cast<LogLevel>(line.level);
+        bool colored = level != LogLevel::Info;
+        if (colored) {
+            ImGui::PushStyleColor(ImGuiCol_Text, levelColor(level));
+        }
+
+        for (size_t i = firstRow; i < firstRow + rowCount; ++i) {
+            const char* rowBegin = i > 0 ? line.begin + points[i - 1] : line.begin;
+            const char* rowEnd = i < breakCount ? line.begin + points[i] : line.end;
+            while (rowEnd > rowBegin && (rowEnd[-1] == '\n' || rowEnd[-1] == '\r')) {
+                --rowEnd;
+            }
+            if (i > 0) {
+                ImGui::SetCursorPosX(textX);
+            }
+            if (spanCount > 0) {
+                renderColoredText(rowBegin, rowEnd, static_cast<size_t>(rowBegin - line.begin), spans, spanCount);
+            }
+            else {
+                ImGui::TextUnformatted(rowBegin, rowEnd);
+            }
+        }
+
+        if (colored) {
+            ImGui::PopStyleColor();
+        }
+    }
+
+    //     ;      -  
+    void renderRepeat(const LogStore& logs, uint64_t id) {
+        const LineRepeat* repeat = logs.repeatOf(id);
+        if (!repeat) {
+            return;
+        }
+        ImGui::SameLine();
+        ImGui::TextDisabled("(x%u)", repeat->count);
+        if (ImGui::IsItemHovered()) {
+            char first[TimestampFormatter::MaxLength];
+            char last[TimestampFormatter::MaxLength];
+            size_t firstLength = timestampFormatter.format(logs.line(id).timestamp, first);
+            size_t lastLength = timestampFormatter.format(repeat->lastTimestamp, last);
+            ImGui::SetTooltip(u8" : %.*s\n : %.*s", static_cast<int>(firstLength), first,
+                static_cast<int>(lastLength), last);
+        }
+    }
+
+    //      
+    static ImVec4 levelColor(LogLevel level) {
+        return level == LogLevel::Error ? ImVec4(1.0f, 0.4f, 0.4f, 1.0f) :
+            level == LogLevel::Warning ? ImVec4(1.0f, 0.8f, 0.3f, 1.0f) :
+            ImVec4(0.6f, 0.6f, 0.6f, 1.0f);
+    }
+
+    //     ANSI; offset -  begin   .
+    //        ( )
+    void renderColoredText(const char* begin, const char* end, size_t offset, const ColorSpan* spans, size_t spanCount) {
+        size_t length = static_cast<size_t>(end - begin);
+        size_t position = 0;
+        bool first = true;
+        auto piece = [&first](const char* pieceBegin, const char* pieceEnd, ImU32 color) {
+            if (!first) {
+                ImGui::SameLine(0.0f, 0.0f);
+            }
+            first = false;
+            ImGui::PushStyleColor(ImGuiCol_Text, color);
+            ImGui::TextUnformatted(pieceBegin, pieceEnd);
+            ImGui::PopStyleColor();
+        };
+
+        ImU32 textColor = ImGui::GetColorU32(ImGuiCol_Text);
+        for (size_t i = 0; i < spanCount; ++i) {
+            size_t spanBegin = spans[i].offset;
+            size_t spanEnd = spanBegin + spans[i].length;
+            if (spanEnd <= offset + position) {
+                continue;
+            }
+            if (spanBegin >= offset + length) {
+                break;
+            }
+            spanBegin = std::max(spanBegin, offset + position) - offset;
+            spanEnd = std::min(spanEnd, offset + length) - offset;
+            if (spanBegin > position) {
+                piece(begin + position, begin + spanBegin, textColor);
+            }
+            piece(begin + spanBegin, begin + spanEnd, spans[i].color);
+            position = spanEnd;
+        }
+        if (position < length || first) {
+            piece(begin + position, end, textColor);
+        }
+    }
+
+    //   : ,  ( )    
+    // (  ANSI -  )
+    void renderLogLine(const LogLine& line, const ColorSpan* spans, size_t spanCount) {
+        char timestamp[TimestampFormatter::MaxLength];
+        size_t length = timestampFormatter.format(line.timestamp, timestamp);
+        ImGui::TextUnformatted(timestamp, timestamp + length);
+        ImGui::SameLine();
+
+        if (line.source != Logger::ConsoleChannel && line.source < channelNames.size()) {
+            ImGui::TextDisabled("[%s]", channelNames[line.source].c_str());
+            ImGui::SameLine();
+        }
+
+        LogLevel level = static_cast<LogLevel>(line.level);
+        if (level == LogLevel::Info && spanCount == 0) {
+            ImGui::TextUnformatted(line.begin, line.end);
+            return;
+        }
+
+        if (level != LogLevel::Info) {
+            ImGui::PushStyleColor(ImGuiCol_Text, levelColor(level));
+        }
+        if (spanCount > 0) {
+            renderColoredText(line.begin, line.end, 0, spans, spanCount);
+        }
+        else {
+            ImGui::TextUnformatted(line.begin, line.end);
+        }
+        if (level != LogLevel::Info) {
+            ImGui::PopStyleColor();
+        }
+    }
+
+    //         Tab
     int inputTextCallback(ImGuiInputTextCallbackData* data) {
+        if (data->EventFlag == ImGuiInputTextFlags_CallbackAlways) {
+            //       (, ), ImGui 
+            //  ,        :  -  .
+            // ,   ,  
+            if (commandRefocused && data->SelectionStart == 0 && data->SelectionEnd == data->BufTextLen) {
+                data->CursorPos = data->BufTextLen;
+                data->SelectionStart = data->SelectionEnd = data->CursorPos;
+            }
+            commandRefocused = false;
+            return 0;
+        }
+        if (data->EventFlag == ImGuiInputTextFlags_CallbackCompletion) {
+            std::string_view input(data->Buf, static_cast<size_t>(data->CursorPos));
+            std::string completed;
+            std::vector<std::string> options;
+            size_t total = 0;
+            if (!processor->complete(input, completed, options, total)) {
+                return 0;
+            }
+            if (completed != input) {
+                // InsertChars    ,      :
+                //  ,      
+                size_t after = static_cast<size_t>(data->BufTextLen - data->CursorPos);
+                if (completed.size() + after >= static_cast<size_t>(data->BufSize)) {
+                    logger->setStatusMessage(u8"     ");
+                    return 0;
+                }
+                data->DeleteChars(0, data->CursorPos);
+                data->InsertChars(0, completed.c_str());
+            }
+            else if (!options.empty()) {
+                //   :  
+                std::string message = u8":";
+                for (const std::string& option : options) {
+                    message += "  " + option;
+                }
+                if (total > options.size()) {
+                    message += u8"  (  " + std::to_string(total - options.size()) + ")";
+                }
+                logger->log(message);
+            }
+            return 0;
+        }
         if (data->EventFlag == ImGuiInputTextFlags_CallbackHistory) {
             //   /    
             if (data->EventKey == ImGuiKey_UpArrow) {
@@ -469,8 +1840,25 @@ public:
         }
     }
 
+    //       (some_service | console-manager --stdin)
+    bool readStdin() {
+        stdinReader = StreamReader::forStdin(logger);
+        std::string error;
+        if (!stdinReader->start(error)) {
+            logger->log(LogLevel::Error, u8"   : " + error);
+            stdinReader.reset();
+            return false;
+        }
+        return true;
+    }
+
     //  
     void shutdown() {
+        processor->stopJobs();
+        tails.clear();
+        receivers.clear();
+        stdinReader.reset();
+        processManager->shutdown();
         if (window) {
             ImGui_ImplOpenGL3_Shutdown();
             ImGui_ImplGlfw_Shutdown();
@@ -493,9 +1881,20 @@ public:
     }
 };
 
-int main()
+int main(int argc, char* argv[])
 {
     ImGuiUI ui;
+    for (int i = 1; i < argc; ++i) {
+        std::string option = argv[i];
+        if (option == "--stdin") {
+            ui.readStdin();
+        }
+        else {
+            std::cerr << " : " << option << std::endl;
+            std::cerr << ": console-manager [--stdin]" << std::endl;
+            return 1;
+        }
+    }
     ui.run();
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,627 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "Logger.h"
+#include "LineBatcher.h"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <poll.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#ifdef __linux__
+#include <sys/epoll.h>
+#endif
+extern char** environ;
+#endif
+
+//      
+struct ProcessInfo {
+    uint32_t pid;
+    std::string command;
+    uint16_t outChannel;        //   
+    uint16_t errChannel;        //   
+    bool running;
+    int exitCode;
+};
+
+//       .
+//       -:  Linux  
+//   epoll,  Windows      
+//  (IOCP).    (stdout  stderr)     ,
+//      .  
+//      
+class ProcessManager {
+public:
+    static const size_t ReadBlock = 64 * 1024;
+
+private:
+    //    
+    struct Stream {
+        LineBatcher batcher;
+        std::atomic<bool> open;     //   -,   processesMutex
+#ifdef _WIN32
+        HANDLE pipe;
+        OVERLAPPED overlapped;
+#else
+        int fd;
+#endif
+
+        Stream(std::shared_ptr<Logger> logger, uint16_t channel) :
+            batcher(logger, channel),
+            open(false),
+#ifdef _WIN32
+            pipe(INVALID_HANDLE_VALUE),
+            overlapped() {}
+#else
+            fd(-1) {}
+#endif
+    };
+
+    struct Process {
+        ProcessInfo info;
+        Stream out;
+        Stream err;
+#ifdef _WIN32
+        HANDLE handle;
+#endif
+
+        Process(std::shared_ptr<Logger> logger, const ProcessInfo& info) :
+            info(info),
+            out(logger, info.outChannel),
+            err(logger, info.errChannel)
+#ifdef _WIN32
+            , handle(NULL)
+#endif
+        {}
+    };
+
+    std::shared_ptr<Logger> logger;
+    mutable std::mutex processesMutex;
+    std::vector<std::unique_ptr<Process>> processes;    //    ( )
+
+    std::thread worker;
+    std::atomic<bool> stopping;
+#ifdef _WIN32
+    HANDLE port;
+    uint32_t pipeCounter;
+#else
+    int wakePipe[2];
+#ifdef __linux__
+    int epoll;
+#endif
+#endif
+
+public:
+    ProcessManager(std::shared_ptr<Logger> logger) :
+        logger(logger),
+        stopping(false)
+#ifdef _WIN32
+        , port(NULL),
+        pipeCounter(0)
+#elif defined(__linux__)
+        , epoll(-1)
+#endif
+    {
+#ifndef _WIN32
+        wakePipe[0] = wakePipe[1] = -1;
+#endif
+    }
+
+    ~ProcessManager() {
+        shutdown();
+    }
+
+    ProcessManager(const ProcessManager&) = delete;
+    ProcessManager& operator=(const ProcessManager&) = delete;
+
+    //  ;       pid
+    bool run(const std::vector<std::string>& arguments, uint32_t& pid, std::string& error) {
+        if (arguments.empty()) {
+            error = u8"  ";
+            return false;
+        }
+        if (!startWorker(error)) {
+            return false;
+        }
+
+        std::string command;
+        for (size_t i = 0; i < arguments.size(); ++i) {
+            command += (i > 0 ? " " : "") + arguments[i];
+        }
+        std::string name = arguments[0].substr(arguments[0].find_last_of("/\\") + 1);
+
+#ifdef _WIN32
+        HANDLE outWrite = NULL;
+        HANDLE errWrite = NULL;
+        HANDLE outRead = createPipe(outWrite);
+        HANDLE errRead = outRead != INVALID_HANDLE_VALUE ? createPipe(errWrite) : INVALID_HANDLE_VALUE;
+        if (errRead == INVALID_HANDLE_VALUE) {
+            if (outRead != INVALID_HANDLE_VALUE) {
+                CloseHandle(outRead);
+                CloseHandle(outWrite);
+            }
+            error = u8"   ";
+            return false;
+        }
+
+        SECURITY_ATTRIBUTES inheritable = { sizeof(SECURITY_ATTRIBUTES), NULL, TRUE };
+        HANDLE nullInput = CreateFileA("NUL", GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, &inheritable,
+            OPEN_EXISTING, 0, NULL);
+
+        STARTUPINFOA startup = {};
+        startup.cb = sizeof(startup);
+        startup.dwFlags = STARTF_USESTDHANDLES;
+        startup.hStdInput = nullInput;
+        startup.hStdOutput = outWrite;
+        startup.hStdError = errWrite;
+
+        std::string commandLine;
+        for (size_t i = 0; i < arguments.size(); ++i) {
+            commandLine += (i > 0 ? " " : "") + quoteArgument(arguments[i]);
+        }
+        PROCESS_INFORMATION created = {};
+        BOOL started = CreateProcessA(NULL, &commandLine[0], NULL, NULL, TRUE, CREATE_NO_WINDOW, NULL, NULL,
+            &startup, &created);
+        DWORD spawnError = started ? 0 : GetLastError();
+        //         
+        CloseHandle(outWrite);
+        CloseHandle(errWrite);
+        if (nullInput != INVALID_HANDLE_VALUE) {
+            CloseHandle(nullInput);
+        }
+        if (!started) {
+            CloseHandle(outRead);
+            CloseHandle(errRead);
+            error = u8"   " + arguments[0] + u8" ( " + std::to_string(spawnError) + ")";
+            return false;
+        }
+        CloseHandle(created.hThread);
+        pid = created.dwProcessId;
+#else
+        int outPipe[2];
+        int errPipe[2];
+        if (!createPipe(outPipe)) {
+            error = std::strerror(errno);
+            return false;
+        }
+        if (!createPipe(errPipe)) {
+            error = std::strerror(errno);
+            close(outPipe[0]);
+            close(outPipe[1]);
+            return false;
+        }
+
+        posix_spawn_file_actions_t actions;
+        posix_spawn_file_actions_init(&actions);
+        posix_spawn_file_actions_addopen(&actions, STDIN_FILENO, "/dev/null", O_RDONLY, 0);
+        posix_spawn_file_actions_adddup2(&actions, outPipe[1], STDOUT_FILENO);
+        posix_spawn_file_actions_adddup2(&actions, errPipe[1], STDERR_FILENO);
+
+        std::vector<char*> argv;
+        for (const std::string& argument : arguments) {
+            argv.push_back(const_cast<char*>(argument.c_str()));
+        }
+        argv.push_back(nullptr);
+
+        pid_t child = 0;
+        int result = posix_spawnp(&child, argv[0], &actions, nullptr, argv.data(), environ);
+        posix_spawn_file_actions_destroy(&actions);
+        close(outPipe[1]);
+        close(errPipe[1]);
+        if (result != 0) {
+            close(outPipe[0]);
+            close(errPipe[0]);
+            error = arguments[0] + ": " + std::strerror(result);
+            return false;
+        }
+        pid = static_cast<uint32_t>(child);
+#endif
+
+        ProcessInfo info;
+        info.pid = pid;
+        info.command = command;
+        info.outChannel = logger->registerChannel(name + ":" + std::to_string(pid));
+        info.errChannel = logger->registerChannel(name + ":" + std::to_string(pid) + ":err");
+        info.running = true;
+        info.exitCode = 0;
+
+        std::unique_ptr<Process> process(new Process(logger, info));
+        Process* added = process.get();
+#ifdef _WIN32
+        added->handle = created.hProcess;
+        added->out.pipe = outRead;
+        added->err.pipe = errRead;
+#else
+        added->out.fd = outPipe[0];
+        added->err.fd = errPipe[0];
+#endif
+        added->out.open = true;
+        added->err.open = true;
+        {
+            std::lock_guard<std::mutex> lock(processesMutex);
+            processes.push_back(std::move(process));
+        }
+        watch(added->out);
+        watch(added->err);
+#ifndef _WIN32
+        wake();
+#endif
+        return true;
+    }
+
+    //  
+    bool terminate(uint32_t pid) {
+        std::lock_guard<std::mutex> lock(processesMutex);
+        for (const auto& process : processes) {
+            if (process->info.pid == pid && process->info.running) {
+#ifdef _WIN32
+                return TerminateProcess(process->handle, 1) != 0;
+#else
+                return kill(static_cast<pid_t>(pid), SIGTERM) == 0;
+#endif
+            }
+        }
+        return false;
+    }
+
+    //   
+    std::vector<ProcessInfo> list() const {
+        std::lock_guard<std::mutex> lock(processesMutex);
+        std::vector<ProcessInfo> result;
+        for (const auto& process : processes) {
+            result.push_back(process->info);
+        }
+        return result;
+    }
+
+    //       -
+    void shutdown() {
+        {
+            std::lock_guard<std::mutex> lock(processesMutex);
+            for (const auto& process : processes) {
+                if (process->info.running) {
+#ifdef _WIN32
+                    TerminateProcess(process->handle, 1);
+#else
+                    kill(static_cast<pid_t>(process->info.pid), SIGKILL);
+#endif
+                }
+            }
+        }
+        if (worker.joinable()) {
+            stopping.store(true);
+#ifdef _WIN32
+            PostQueuedCompletionStatus(port, 0, 0, NULL);
+#else
+            wake();
+#endif
+            worker.join();
+        }
+
+        std::lock_guard<std::mutex> lock(processesMutex);
+        for (const auto& process : processes) {
+            closeStream(process->out);
+            closeStream(process->err);
+#ifdef _WIN32
+            if (process->handle) {
+                CloseHandle(process->handle);
+                process->handle = NULL;
+            }
+#else
+            if (process->info.running) {
+                waitpid(static_cast<pid_t>(process->info.pid), nullptr, 0);
+                process->info.running = false;
+            }
+#endif
+        }
+#ifdef _WIN32
+        if (port) {
+            CloseHandle(port);
+            port = NULL;
+        }
+#else
+        for (int& fd : wakePipe) {
+            if (fd >= 0) {
+                close(fd);
+                fd = -1;
+            }
+        }
+#ifdef __linux__
+        if (epoll >= 0) {
+            close(epoll);
+            epoll = -1;
+        }
+#endif
+#endif
+    }
+
+private:
+    //  -     
+    bool startWorker(std::string& error) {
+        if (worker.joinable()) {
+            return true;
+        }
+#ifdef _WIN32
+        port = CreateIoCompletionPort(INVALID_HANDLE_VALUE, NULL, 0, 1);
+        if (!port) {
+            error = u8"    ";
+            return false;
+        }
+#else
+        if (!createPipe(wakePipe, true)) {
+            error = std::strerror(errno);
+            return false;
+        }
+#ifdef __linux__
+        epoll = epoll_create1(EPOLL_CLOEXEC);
+        struct epoll_event event = {};
+        event.events = EPOLLIN;
+        event.data.ptr = nullptr;
+        if (epoll < 0 || epoll_ctl(epoll, EPOLL_CTL_ADD, wakePipe[0], &event) != 0) {
+            error = std::strerror(errno);
+            return false;
+        }
+#endif
+#endif
+        worker = std::thread([this]() { run(); });
+        return true;
+    }
+
+    void run() {
+        while (!stopping.load()) {
+            waitAndRead(hasUnreaped() ? 200 : -1);
+            reapExited();
+        }
+    }
+
+    //  ,   ,     
+    bool hasUnreaped() const {
+        std::lock_guard<std::mutex> lock(processesMutex);
+        for (const auto& process : processes) {
+            if (process->info.running && !process->out.open && !process->err.open) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    //    ,     
+    void reapExited() {
+        std::lock_guard<std::mutex> lock(processesMutex);
+        for (const auto& process : processes) {
+            if (!process->info.running || process->out.open || process->err.open) {
+                continue;
+            }
+#ifdef _WIN32
+            DWORD code = 0;
+            if (WaitForSingleObject(process->handle, 0) != WAIT_OBJECT_0 || !GetExitCodeProcess(process->handle, &code)) {
+                continue;
+            }
+            CloseHandle(process->handle);
+            process->handle = NULL;
+            process->info.exitCode = static_cast<int>(code);
+#else
+            int status = 0;
+            if (waitpid(static_cast<pid_t>(process->info.pid), &status, WNOHANG) <= 0) {
+                continue;
+            }
+            process->info.exitCode = WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status);
+#endif
+            process->info.running = false;
+            std::string message = u8" " + std::to_string(process->info.pid) + u8"    " +
+                std::to_string(process->info.exitCode);
+            logger->log(process->info.exitCode == 0 ? LogLevel::Info : LogLevel::Warning,
+                process->info.outChannel, message.data(), message.size());
+        }
+    }
+
+    //  :      
+    void closeStream(Stream& stream) {
+        if (!stream.open) {
+            return;
+        }
+        stream.batcher.finish();
+#ifdef _WIN32
+        CancelIoEx(stream.pipe, NULL);
+        CloseHandle(stream.pipe);
+        stream.pipe = INVALID_HANDLE_VALUE;
+#else
+#ifdef __linux__
+        epoll_ctl(epoll, EPOLL_CTL_DEL, stream.fd, nullptr);
+#endif
+        close(stream.fd);
+        stream.fd = -1;
+#endif
+        stream.open = false;
+    }
+
+#ifdef _WIN32
+    static std::string quoteArgument(const std::string& argument) {
+        if (!argument.empty() && argument.find_first_of(" \t\"") == std::string::npos) {
+            return argument;
+        }
+        std::string quoted = "\"";
+        for (char c : argument) {
+            if (c == '"') {
+                quoted += '\\';
+            }
+            quoted += c;
+        }
+        return quoted + "\"";
+    }
+
+    //  :     -,
+    //     
+    HANDLE createPipe(HANDLE& writeEnd) {
+        std::string name = "\\\\.\\pipe\\console-manager-" + std::to_string(GetCurrentProcessId()) + "-" +
+            std::to_string(pipeCounter++);
+        HANDLE readEnd = CreateNamedPipeA(name.c_str(), PIPE_ACCESS_INBOUND | FILE_FLAG_OVERLAPPED |
+            FILE_FLAG_FIRST_PIPE_INSTANCE, PIPE_TYPE_BYTE | PIPE_WAIT, 1, 0, static_cast<DWORD>(ReadBlock), 0, NULL);
+        if (readEnd == INVALID_HANDLE_VALUE) {
+            return INVALID_HANDLE_VALUE;
+        }
+        SECURITY_ATTRIBUTES inheritable = { sizeof(SECURITY_ATTRIBUTES), NULL, TRUE };
+        writeEnd = CreateFileA(name.c_str(), GENERIC_WRITE, 0, &inheritable, OPEN_EXISTING, 0, NULL);
+        if (writeEnd == INVALID_HANDLE_VALUE) {
+            CloseHandle(readEnd);
+            return INVALID_HANDLE_VALUE;
+        }
+        return readEnd;
+    }
+
+    //         
+    void watch(Stream& stream) {
+        CreateIoCompletionPort(stream.pipe, port, reinterpret_cast<ULONG_PTR>(&stream), 0);
+        issueRead(stream);
+    }
+
+    //   ;     
+    void issueRead(Stream& stream) {
+        stream.overlapped = OVERLAPPED();
+        char* target = stream.batcher.reserve(ReadBlock);
+        if (!ReadFile(stream.pipe, target, static_cast<DWORD>(ReadBlock), NULL, &stream.overlapped) &&
+            GetLastError() != ERROR_IO_PENDING) {
+            //    (ERROR_BROKEN_PIPE):    
+            stream.batcher.commit(0);
+            closeStream(stream);
+        }
+    }
+
+    void waitAndRead(int timeout) {
+        DWORD received = 0;
+        ULONG_PTR key = 0;
+        OVERLAPPED* overlapped = NULL;
+        BOOL ok = GetQueuedCompletionStatus(port, &received, &key, &overlapped, timeout < 0 ? INFINITE : timeout);
+        if (!overlapped || key == 0) {
+            return;     //    
+        }
+        Stream& stream = *reinterpret_cast<Stream*>(key);
+        stream.batcher.commit(ok ? received : 0);
+        if (!ok || stopping.load()) {
+            closeStream(stream);
+        }
+        else {
+            issueRead(stream);
+        }
+    }
+#else
+    //   FD_CLOEXEC;   ,  -  nonBlockingWrite.
+    //  Linux     :     
+    //  ,     pipe()  fcntl()
+    static bool createPipe(int ends[2], bool nonBlockingWrite = false) {
+#ifdef __linux__
+        if (pipe2(ends, O_CLOEXEC | (nonBlockingWrite ? O_NONBLOCK : 0)) != 0) {
+            return false;
+        }
+#else
+        if (pipe(ends) != 0) {
+            return false;
+        }
+        for (int i = 0; i < 2; ++i) {
+            fcntl(ends[i], F_SETFD, FD_CLOEXEC);
+        }
+        if (nonBlockingWrite) {
+            fcntl(ends[1], F_SETFL, O_NONBLOCK);
+        }
+#endif
+        //          ,
+        //  O_NONBLOCK     
+        fcntl(ends[0], F_SETFL, O_NONBLOCK);
+        return true;
+    }
+
+    void watch(Stream& stream) {
+#ifdef __linux__
+        struct epoll_event event = {};
+        event.events = EPOLLIN;
+        event.data.ptr = &stream;
+        epoll_ctl(epoll, EPOLL_CTL_ADD, stream.fd, &event);
+#endif
+    }
+
+    //   - (   )
+    void wake() {
+        char signal = 0;
+        if (write(wakePipe[1], &signal, 1) < 0) {
+            //    -    
+        }
+    }
+
+    void waitAndRead(int timeout) {
+        std::vector<Stream*> ready;
+#ifdef __linux__
+        struct epoll_event events[64];
+        int count = epoll_wait(epoll, events, 64, timeout);
+        for (int i = 0; i < count; ++i) {
+            ready.push_back(static_cast<Stream*>(events[i].data.ptr));
+        }
+#else
+        //  epoll    poll
+        std::vector<Stream*> streams;
+        std::vector<struct pollfd> fds(1);
+        fds[0].fd = wakePipe[0];
+        fds[0].events = POLLIN;
+        {
+            std::lock_guard<std::mutex> lock(processesMutex);
+            for (const auto& process : processes) {
+                for (Stream* stream : { &process->out, &process->err }) {
+                    if (stream->open) {
+                        struct pollfd entry = {};
+                        entry.fd = stream->fd;
+                        entry.events = POLLIN;
+                        fds.push_back(entry);
+                        streams.push_back(stream);
+                    }
+                }
+            }
+        }
+        if (poll(fds.data(), fds.size(), timeout) > 0) {
+            if (fds[0].revents) {
+                ready.push_back(nullptr);
+            }
+            for (size_t i = 1; i < fds.size(); ++i) {
+                if (fds[i].revents) {
+                    ready.push_back(streams[i - 1]);
+                }
+            }
+        }
+#endif
+        for (Stream* stream : ready) {
+            if (!stream) {
+                char drained[64];
+                while (read(wakePipe[0], drained, sizeof(drained)) > 0) {
+                }
+                continue;
+            }
+            //        -     
+            char* target = stream->batcher.reserve(ReadBlock);
+            ssize_t received = read(stream->fd, target, ReadBlock);
+            stream->batcher.commit(received > 0 ? static_cast<size_t>(received) : 0);
+            if (received == 0 || (received < 0 && errno != EAGAIN && errno != EINTR)) {
+                closeStream(*stream);
+            }
+        }
+    }
+#endif
+};
\ No newline at end of file
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+
+//    .
+//         O(1).
+//     ,     
+//   :     firstIndex()  endIndex().
+template <typename T>
+class RingBuffer {
+private:
+    std::vector<T> items;   //     ,    capacity
+    size_t cap;
+    size_t head;            //      items
+    size_t count;
+    uint64_t first;         //     
+
+public:
+    class const_iterator {
+    private:
+        const RingBuffer* ring;
+        size_t pos;
+
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T*;
+        using reference = const T&;
+
+        const_iterator(const RingBuffer* ring, size_t pos) : ring(ring), pos(pos) {}
+
+        reference operator*() const { return ring->at(pos); }
+        pointer operator->() const { return &ring->at(pos); }
+        reference operator[](difference_type n) const { return ring->at(pos + n); }
+
+        const_iterator& operator++() { ++pos; return *this; }
+        const_iterator operator++(int) { const_iterator tmp = *this; ++pos; return tmp; }
+        const_iterator& operator--() { --pos; return *this; }
+        const_iterator operator--(int) { const_iterator tmp = *this; --pos; return tmp; }
+        const_iterator& operator+=(difference_type n) { pos += n; return *this; }
+        const_iterator& operator-=(difference_type n) { pos -= n; return *this; }
+        const_iterator operator+(difference_type n) const { return const_iterator(ring, pos + n); }
+        const_iterator operator-(difference_type n) const { return const_iterator(ring, pos - n); }
+        difference_type operator-(const const_iterator& other) const {
+            return static_cast<difference_type>(pos) - static_cast<difference_type>(other.pos);
+        }
+
+        bool operator==(const const_iterator& other) const { return pos == other.pos; }
+        bool operator!=(const const_iterator& other) const { return pos != other.pos; }
+        bool operator<(const const_iterator& other) const { return pos < other.pos; }
+        bool operator>(const const_iterator& other) const { return pos > other.pos; }
+        bool operator<=(const const_iterator& other) const { return pos <= other.pos; }
+        bool operator>=(const const_iterator& other) const { return pos >= other.pos; }
+    };
+
+    RingBuffer(size_t capacity) : cap(capacity > 0 ? capacity : 1), head(0), count(0), first(0) {}
+
+    //  ,     
+    void push_back(const T& value) {
+        emplace() = value;
+    }
+
+    void push_back(T&& value) {
+        emplace() = std::move(value);
+    }
+
+    //     .   
+    //      (,  )
+    T& emplace() {
+        if (count < cap) {
+            size_t pos = physical(count);
+            if (pos == items.size()) {
+                items.emplace_back();
+            }
+            ++count;
+            return items[pos];
+        }
+
+        T& slot = items[head];
+        head = (head + 1) % cap;
+        ++first;
+        return slot;
+    }
+
+    //   .    
+    void clear() {
+        first += count;
+        head = 0;
+        count = 0;
+        items.clear();
+    }
+
+    //       (0 .. size()-1)
+    const T& at(size_t pos) const {
+        return items[physical(pos)];
+    }
+
+    T& at(size_t pos) {
+        return items[physical(pos)];
+    }
+
+    const T& operator[](size_t pos) const { return at(pos); }
+    T& operator[](size_t pos) { return at(pos); }
+
+    // ,       
+    bool contains(uint64_t index) const {
+        return index >= first && index < first + count;
+    }
+
+    //     (  contains)
+    const T& byIndex(uint64_t index) const {
+        return at(static_cast<size_t>(index - first));
+    }
+
+    const T& front() const { return at(0); }
+    const T& back() const { return at(count - 1); }
+
+    uint64_t firstIndex() const { return first; }
+    uint64_t endIndex() const { return first + count; }
+
+    size_t size() const { return count; }
+    size_t capacity() const { return cap; }
+    bool empty() const { return count == 0; }
+
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, count); }
+
+private:
+    size_t physical(size_t pos) const {
+        size_t p = head + pos;
+        return p >= cap ? p - cap : p;
+    }
+};
\ No newline at end of file
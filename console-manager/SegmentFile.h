@@ -0,0 +1,311 @@
+#pragma once
+
+#include <string>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#include <winioctl.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#ifdef __linux__
+#include <linux/falloc.h>
+#endif
+#endif
+
+//      ( ).
+//   
+class MappedRegion {
+private:
+    void* base;             //   (   )
+    size_t length;          //  
+    const char* bytes;      //    
+
+public:
+    MappedRegion() : base(nullptr), length(0), bytes(nullptr) {}
+    MappedRegion(void* base, size_t length, const char* bytes) : base(base), length(length), bytes(bytes) {}
+
+    MappedRegion(MappedRegion&& other) noexcept : base(other.base), length(other.length), bytes(other.bytes) {
+        other.base = nullptr;
+        other.bytes = nullptr;
+    }
+
+    MappedRegion& operator=(MappedRegion&& other) noexcept {
+        if (this != &other) {
+            reset();
+            base = other.base;
+            length = other.length;
+            bytes = other.bytes;
+            other.base = nullptr;
+            other.bytes = nullptr;
+        }
+        return *this;
+    }
+
+    MappedRegion(const MappedRegion&) = delete;
+    MappedRegion& operator=(const MappedRegion&) = delete;
+
+    ~MappedRegion() {
+        reset();
+    }
+
+    const char* data() const { return bytes; }
+    bool valid() const { return bytes != nullptr; }
+
+    void reset() {
+        if (base) {
+#ifdef _WIN32
+            UnmapViewOfFile(base);
+#else
+            munmap(base, length);
+#endif
+        }
+        base = nullptr;
+        bytes = nullptr;
+        length = 0;
+    }
+};
+
+//      (     ).
+//            
+class SegmentFile {
+private:
+#ifdef _WIN32
+    HANDLE handle;
+#else
+    int fd;
+#endif
+    uint64_t size;
+    std::string path;       //    
+
+    SegmentFile() :
+#ifdef _WIN32
+        handle(INVALID_HANDLE_VALUE),
+#else
+        fd(-1),
+#endif
+        size(0) {}
+
+public:
+    ~SegmentFile() {
+#ifdef _WIN32
+        if (handle != INVALID_HANDLE_VALUE) {
+            CloseHandle(handle);
+        }
+#else
+        if (fd >= 0) {
+            close(fd);
+        }
+#endif
+    }
+
+    SegmentFile(const SegmentFile&) = delete;
+    SegmentFile& operator=(const SegmentFile&) = delete;
+
+    //   ,     
+    static std::shared_ptr<SegmentFile> createTemporary() {
+        std::shared_ptr<SegmentFile> file(new SegmentFile());
+#ifdef _WIN32
+        char directory[MAX_PATH];
+        char path[MAX_PATH];
+        if (!GetTempPathA(MAX_PATH, directory) || !GetTempFileNameA(directory, "clg", 0, path)) {
+            return nullptr;
+        }
+        file->handle = CreateFileA(path, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_DELETE, NULL,
+            CREATE_ALWAYS, FILE_ATTRIBUTE_TEMPORARY | FILE_FLAG_DELETE_ON_CLOSE, NULL);
+        if (file->handle == INVALID_HANDLE_VALUE) {
+            return nullptr;
+        }
+        //       
+        DWORD returned = 0;
+        DeviceIoControl(file->handle, FSCTL_SET_SPARSE, NULL, 0, NULL, 0, &returned, NULL);
+#else
+        const char* directory = getenv("TMPDIR");
+        std::string path = std::string(directory && *directory ? directory : "/tmp") + "/console-manager-XXXXXX";
+        //     run:       
+        //   ,    
+#ifdef __linux__
+        file->fd = mkostemp(&path[0], O_CLOEXEC);
+#else
+        file->fd = mkstemp(&path[0]);
+        if (file->fd >= 0) {
+            fcntl(file->fd, F_SETFD, FD_CLOEXEC);
+        }
+#endif
+        if (file->fd < 0) {
+            return nullptr;
+        }
+        unlink(path.c_str());
+#endif
+        return file;
+    }
+
+    //    : create -   (  ),
+    //   
+    static std::shared_ptr<SegmentFile> open(const std::string& path, bool create, std::string& error) {
+        std::shared_ptr<SegmentFile> file(new SegmentFile());
+#ifdef _WIN32
+        file->handle = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, NULL,
+            create ? CREATE_ALWAYS : OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+        if (file->handle == INVALID_HANDLE_VALUE) {
+            error = u8"   " + path + u8" ( " + std::to_string(GetLastError()) + ")";
+            return nullptr;
+        }
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file->handle, &fileSize)) {
+            error = u8"    " + path;
+            return nullptr;
+        }
+        file->size = static_cast<uint64_t>(fileSize.QuadPart);
+#else
+        file->fd = ::open(path.c_str(), O_RDWR | O_CLOEXEC | (create ? O_CREAT | O_TRUNC : 0), 0644);
+        if (file->fd < 0) {
+            error = path + ": " + std::strerror(errno);
+            return nullptr;
+        }
+        struct stat info;
+        if (fstat(file->fd, &info) != 0) {
+            error = path + ": " + std::strerror(errno);
+            return nullptr;
+        }
+        file->size = static_cast<uint64_t>(info.st_size);
+#endif
+        file->path = path;
+        return file;
+    }
+
+    //        ,   
+    bool append(const void* const* parts, const size_t* lengths, size_t partCount, uint64_t& offset) {
+        offset = size;
+        uint64_t position = size;
+        for (size_t i = 0; i < partCount; ++i) {
+            if (!writeAt(position, static_cast<const char*>(parts[i]), lengths[i])) {
+                return false;
+            }
+            position += lengths[i];
+        }
+        size = position;
+        return true;
+    }
+
+    //     
+    MappedRegion map(uint64_t offset, size_t length) const {
+        if (length == 0 || offset + length > size) {
+            return MappedRegion();
+        }
+        uint64_t aligned = offset - offset % granularity();
+        size_t delta = static_cast<size_t>(offset - aligned);
+#ifdef _WIN32
+        HANDLE mapping = CreateFileMappingA(handle, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (!mapping) {
+            return MappedRegion();
+        }
+        void* base = MapViewOfFile(mapping, FILE_MAP_READ, static_cast<DWORD>(aligned >> 32),
+            static_cast<DWORD>(aligned & 0xFFFFFFFF), delta + length);
+        CloseHandle(mapping);  //     UnmapViewOfFile
+        if (!base) {
+            return MappedRegion();
+        }
+#else
+        void* base = mmap(nullptr, delta + length, PROT_READ, MAP_SHARED, fd, static_cast<off_t>(aligned));
+        if (base == MAP_FAILED) {
+            return MappedRegion();
+        }
+#endif
+        return MappedRegion(base, delta + length, static_cast<const char*>(base) + delta);
+    }
+
+    //      ,    .
+    //      (   "")
+    void release(uint64_t offset, size_t length) {
+#ifdef _WIN32
+        FILE_ZERO_DATA_INFORMATION range;
+        range.FileOffset.QuadPart = static_cast<LONGLONG>(offset);
+        range.BeyondFinalZero.QuadPart = static_cast<LONGLONG>(offset + length);
+        DWORD returned = 0;
+        DeviceIoControl(handle, FSCTL_SET_ZERO_DATA, &range, sizeof(range), NULL, 0, &returned, NULL);
+#elif defined(FALLOC_FL_PUNCH_HOLE)
+        fallocate(fd, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE, static_cast<off_t>(offset), static_cast<off_t>(length));
+#else
+        (void)offset;
+        (void)length;
+#endif
+    }
+
+    //    length (  -  ). Windows  
+    //    ;      
+    void truncate(uint64_t length = 0) {
+#ifdef _WIN32
+        LARGE_INTEGER position;
+        position.QuadPart = static_cast<LONGLONG>(length);
+        SetFilePointerEx(handle, position, NULL, FILE_BEGIN);
+        SetEndOfFile(handle);
+#else
+        if (ftruncate(fd, static_cast<off_t>(length)) != 0) {
+            return;
+        }
+#endif
+        size = length;
+    }
+
+    //     
+    bool sync() {
+#ifdef _WIN32
+        return FlushFileBuffers(handle) != 0;
+#else
+        return fsync(fd) == 0;
+#endif
+    }
+
+    uint64_t getSize() const { return size; }
+    const std::string& getPath() const { return path; }
+
+private:
+    bool writeAt(uint64_t position, const char* data, size_t length) {
+        while (length > 0) {
+#ifdef _WIN32
+            OVERLAPPED overlapped = {};
+            overlapped.Offset = static_cast<DWORD>(position & 0xFFFFFFFF);
+            overlapped.OffsetHigh = static_cast<DWORD>(position >> 32);
+            DWORD chunk = length > 0x40000000 ? 0x40000000 : static_cast<DWORD>(length);
+            DWORD written = 0;
+            if (!WriteFile(handle, data, chunk, &written, &overlapped) || written == 0) {
+                return false;
+            }
+#else
+            ssize_t written = pwrite(fd, data, length, static_cast<off_t>(position));
+            if (written <= 0) {
+                return false;
+            }
+#endif
+            data += written;
+            position += written;
+            length -= written;
+        }
+        return true;
+    }
+
+    static uint64_t granularity() {
+#ifdef _WIN32
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        return info.dwAllocationGranularity;
+#else
+        return static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+#endif
+    }
+};
\ No newline at end of file
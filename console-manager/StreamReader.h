@@ -0,0 +1,201 @@
+#pragma once
+
+#include <string>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "Logger.h"
+#include "LineBatcher.h"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <poll.h>
+#endif
+
+//   (   )   .
+//        ,    
+//   .      ,  
+//     ,    .   :
+//    ,   ,  drain()   ,
+//      
+class StreamReader {
+public:
+    static const size_t ReadBlock = 1 << 20;
+
+private:
+    std::shared_ptr<Logger> logger;
+    uint16_t channel;
+    LineBatcher batcher;
+    std::thread worker;
+    std::atomic<bool> stopping;
+    std::atomic<bool> finished;
+#ifdef _WIN32
+    HANDLE input;
+#else
+    int input;
+    int wakePipe[2];
+#endif
+
+public:
+#ifdef _WIN32
+    StreamReader(std::shared_ptr<Logger> logger, uint16_t channel, HANDLE input) :
+#else
+    StreamReader(std::shared_ptr<Logger> logger, uint16_t channel, int input) :
+#endif
+        logger(logger),
+        channel(channel),
+        batcher(logger, channel, LogLevel::Info, false),
+        stopping(false),
+        finished(false),
+        input(input) {
+#ifndef _WIN32
+        wakePipe[0] = wakePipe[1] = -1;
+#endif
+    }
+
+    ~StreamReader() {
+        stop();
+#ifndef _WIN32
+        for (int fd : wakePipe) {
+            if (fd >= 0) {
+                close(fd);
+            }
+        }
+#endif
+    }
+
+    StreamReader(const StreamReader&) = delete;
+    StreamReader& operator=(const StreamReader&) = delete;
+
+    //   
+    static std::unique_ptr<StreamReader> forStdin(std::shared_ptr<Logger> logger) {
+        uint16_t channel = logger->registerChannel("stdin");
+#ifdef _WIN32
+        return std::unique_ptr<StreamReader>(new StreamReader(logger, channel, GetStdHandle(STD_INPUT_HANDLE)));
+#else
+        return std::unique_ptr<StreamReader>(new StreamReader(logger, channel, STDIN_FILENO));
+#endif
+    }
+
+    bool start(std::string& error) {
+#ifndef _WIN32
+#ifdef __linux__
+        int piped = pipe2(wakePipe, O_CLOEXEC);
+#else
+        int piped = pipe(wakePipe);
+        if (piped == 0) {
+            fcntl(wakePipe[0], F_SETFD, FD_CLOEXEC);
+            fcntl(wakePipe[1], F_SETFD, FD_CLOEXEC);
+        }
+#endif
+        if (piped != 0) {
+            error = std::strerror(errno);
+            return false;
+        }
+#else
+        if (input == NULL || input == INVALID_HANDLE_VALUE) {
+            error = u8"  ";
+            return false;
+        }
+#endif
+        worker = std::thread([this]() { run(); });
+        return true;
+    }
+
+    //   (     read -  )
+    void stop() {
+        if (!worker.joinable()) {
+            return;
+        }
+        stopping.store(true);
+#ifdef _WIN32
+        CancelSynchronousIo(worker.native_handle());
+#else
+        char wake = 0;
+        if (write(wakePipe[1], &wake, 1) < 0) {
+            //        
+        }
+#endif
+        worker.join();
+    }
+
+    //   (    )
+    bool isFinished() const {
+        return finished.load();
+    }
+
+private:
+    void run() {
+        while (!stopping.load()) {
+            //   -   stop()
+            if (!logger->waitForQueueSpace(std::chrono::milliseconds(100))) {
+                continue;
+            }
+            char* target = batcher.reserve(ReadBlock);
+            size_t received = 0;
+            if (!readSome(target, received)) {
+                batcher.commit(0);
+                break;
+            }
+            batcher.commit(received);
+        }
+        batcher.finish();
+        if (!stopping.load()) {
+            std::string message = u8"  ";
+            logger->log(LogLevel::Info, channel, message.data(), message.size());
+        }
+        finished.store(true);
+    }
+
+    //  ,     (  ReadBlock). false -   
+    bool readSome(char* target, size_t& received) {
+#ifdef _WIN32
+        DWORD count = 0;
+        //     ERROR_BROKEN_PIPE,   stop() - ERROR_OPERATION_ABORTED
+        if (!ReadFile(input, target, static_cast<DWORD>(ReadBlock), &count, NULL) || count == 0) {
+            return false;
+        }
+        received = count;
+        return true;
+#else
+        struct pollfd fds[2] = {};
+        fds[0].fd = input;
+        fds[0].events = POLLIN;
+        fds[1].fd = wakePipe[0];
+        fds[1].events = POLLIN;
+        while (true) {
+            int ready = poll(fds, 2, -1);
+            if (ready < 0 && errno == EINTR) {
+                continue;
+            }
+            if (ready < 0 || stopping.load()) {
+                return false;
+            }
+            ssize_t count = read(input, target, ReadBlock);
+            if (count < 0 && (errno == EINTR || errno == EAGAIN)) {
+                continue;
+            }
+            if (count <= 0) {
+                return false;
+            }
+            received = static_cast<size_t>(count);
+            return true;
+        }
+#endif
+    }
+};
\ No newline at end of file
@@ -0,0 +1,273 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "LogStore.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define TEXTMATCH_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define TEXTMATCH_TARGET(isa) __attribute__((target(isa)))
+#else
+#define TEXTMATCH_TARGET(isa)
+#endif
+
+//          .
+//   :   16 (SSE2)  32 (AVX2) 
+//      ,    .
+//         0x20:    
+// ,      ,   
+namespace TextMatch {
+
+    inline char fold(char c) {
+        return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c;
+    }
+
+    //  length  text  needle (needle   )
+    inline bool equalNoCase(const char* text, const char* needle, size_t length) {
+        for (size_t i = 0; i < length; ++i) {
+            if (fold(text[i]) != needle[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    //  :   
+    inline const char* findScalar(const char* begin, const char* end, const char* needle, size_t length) {
+        if (length == 0) {
+            return begin;
+        }
+        for (const char* p = begin; p + length <= end; ++p) {
+            if (fold(*p) == needle[0] && equalNoCase(p + 1, needle + 1, length - 1)) {
+                return p;
+            }
+        }
+        return nullptr;
+    }
+
+#ifdef TEXTMATCH_X86
+    inline unsigned countTrailingZeros(uint32_t mask) {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanForward(&index, mask);
+        return static_cast<unsigned>(index);
+#else
+        return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+    }
+
+    TEXTMATCH_TARGET("sse2")
+    inline const char* findSse2(const char* begin, const char* end, const char* needle, size_t length) {
+        const __m128i caseBit = _mm_set1_epi8(0x20);
+        const __m128i first = _mm_set1_epi8(static_cast<char>(needle[0] | 0x20));
+        const __m128i last = _mm_set1_epi8(static_cast<char>(needle[length - 1] | 0x20));
+
+        const char* p = begin;
+        for (; p + length - 1 + 16 <= end; p += 16) {
+            __m128i blockFirst = _mm_or_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)), caseBit);
+            __m128i blockLast = _mm_or_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + length - 1)), caseBit);
+            uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(
+                _mm_and_si128(_mm_cmpeq_epi8(first, blockFirst), _mm_cmpeq_epi8(last, blockLast))));
+            while (mask) {
+                const char* candidate = p + countTrailingZeros(mask);
+                if (equalNoCase(candidate, needle, length)) {
+                    return candidate;
+                }
+                mask &= mask - 1;
+            }
+        }
+        return findScalar(p, end, needle, length);
+    }
+
+    TEXTMATCH_TARGET("avx2")
+    inline const char* findAvx2(const char* begin, const char* end, const char* needle, size_t length) {
+        const __m256i caseBit = _mm256_set1_epi8(0x20);
+        const __m256i first = _mm256_set1_epi8(static_cast<char>(needle[0] | 0x20));
+        const __m256i last = _mm256_set1_epi8(static_cast<char>(needle[length - 1] | 0x20));
+
+        const char* p = begin;
+        for (; p + length - 1 + 32 <= end; p += 32) {
+            __m256i blockFirst = _mm256_or_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)), caseBit);
+            __m256i blockLast = _mm256_or_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + length - 1)), caseBit);
+            uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(
+                _mm256_and_si256(_mm256_cmpeq_epi8(first, blockFirst), _mm256_cmpeq_epi8(last, blockLast))));
+            while (mask) {
+                const char* candidate = p + countTrailingZeros(mask);
+                if (equalNoCase(candidate, needle, length)) {
+                    return candidate;
+                }
+                mask &= mask - 1;
+            }
+        }
+        return findSse2(p, end, needle, length);
+    }
+
+    //   AVX2    
+    inline bool detectAvx2() {
+#ifdef _MSC_VER
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7) {
+            return false;
+        }
+        __cpuid(info, 1);
+        bool osSavesAvx = (info[2] & (1 << 27)) && (_xgetbv(0) & 6) == 6;
+        __cpuidex(info, 7, 0);
+        return osSavesAvx && (info[1] & (1 << 5));
+#else
+        return __builtin_cpu_supports("avx2");
+#endif
+    }
+
+    inline bool hasAvx2() {
+        static const bool supported = detectAvx2();
+        return supported;
+    }
+#endif
+
+    //  needle (  )  [begin, end)   
+    inline const char* find(const char* begin, const char* end, const char* needle, size_t length) {
+        if (length == 0) {
+            return begin;
+        }
+        if (static_cast<size_t>(end - begin) < length) {
+            return nullptr;
+        }
+#ifdef TEXTMATCH_X86
+        return hasAvx2() ? findAvx2(begin, end, needle, length) : findSse2(begin, end, needle, length);
+#else
+        return findScalar(begin, end, needle, length);
+#endif
+    }
+
+    //    (  )
+    inline const char* implementationName() {
+#ifdef TEXTMATCH_X86
+        return hasAvx2() ? "AVX2" : "SSE2";
+#else
+        return "scalar";
+#endif
+    }
+}
+
+//       ImGuiTextFilter: "aaa,bbb,-ccc".
+//  ,        (  )
+//      .     .
+//       ,     
+class TextFilter {
+private:
+    std::string source;
+    std::vector<std::string> includes;
+    std::vector<std::string> excludes;
+
+public:
+    //   ;  true,   
+    bool parse(const char* text) {
+        if (source == text) {
+            return false;
+        }
+        source = text;
+        includes.clear();
+        excludes.clear();
+
+        size_t start = 0;
+        while (start <= source.size()) {
+            size_t comma = source.find(',', start);
+            if (comma == std::string::npos) {
+                comma = source.size();
+            }
+            std::string pattern = source.substr(start, comma - start);
+            pattern.erase(0, pattern.find_first_not_of(" \t"));
+            pattern.erase(pattern.find_last_not_of(" \t") + 1);
+
+            bool exclude = !pattern.empty() && pattern[0] == '-';
+            if (exclude) {
+                pattern.erase(0, 1);
+            }
+            for (char& c : pattern) {
+                c = TextMatch::fold(c);
+            }
+            if (!pattern.empty()) {
+                (exclude ? excludes : includes).push_back(pattern);
+            }
+            start = comma + 1;
+        }
+        return true;
+    }
+
+    bool empty() const {
+        return includes.empty() && excludes.empty();
+    }
+
+    const std::string& text() const {
+        return source;
+    }
+
+    //   passes[i]     [from, to)  (1 - )
+    void matchLines(const LogStore::ChunkColumns& columns, size_t from, size_t to, uint8_t* passes) const {
+        std::fill(passes, passes + (to - from), includes.empty() ? 1 : 0);
+        for (const std::string& pattern : includes) {
+            markLines(columns, from, to, pattern, passes, 1);
+        }
+        for (const std::string& pattern : excludes) {
+            markLines(columns, from, to, pattern, passes, 0);
+        }
+    }
+
+    //       (   )
+    void matchLinesScalar(const LogStore::ChunkColumns& columns, size_t from, size_t to, uint8_t* passes) const {
+        for (size_t line = from; line < to; ++line) {
+            const char* begin = columns.lineBegin(line);
+            const char* end = columns.lineEnd(line);
+            bool pass = includes.empty();
+            for (size_t i = 0; i < includes.size() && !pass; ++i) {
+                pass = TextMatch::findScalar(begin, end, includes[i].data(), includes[i].size()) != nullptr;
+            }
+            for (size_t i = 0; i < excludes.size() && pass; ++i) {
+                pass = TextMatch::findScalar(begin, end, excludes[i].data(), excludes[i].size()) == nullptr;
+            }
+            passes[line - from] = pass ? 1 : 0;
+        }
+    }
+
+private:
+    //        [from, to)    
+    //   ,       
+    static void markLines(const LogStore::ChunkColumns& columns, size_t from, size_t to,
+        const std::string& pattern, uint8_t* passes, uint8_t value) {
+        const char* end = columns.lineEnd(to - 1);
+        const char* p = columns.lineBegin(from);
+        size_t line = from;
+        while (p < end) {
+            const char* hit = TextMatch::find(p, end, pattern.data(), pattern.size());
+            if (!hit) {
+                return;
+            }
+            uint32_t offset = static_cast<uint32_t>(hit - columns.data);
+            line = static_cast<size_t>(std::upper_bound(columns.offsets + line, columns.offsets + to, offset) -
+                columns.offsets) - 1;
+            const char* lineEnd = columns.lineEnd(line);
+            if (hit + pattern.size() <= lineEnd) {
+                passes[line - from] = value;
+                p = lineEnd;
+                ++line;
+            }
+            else {
+                //     -    
+                p = hit + 1;
+            }
+        }
+    }
+};
\ No newline at end of file
@@ -0,0 +1,306 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <chrono>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+#include "LogStore.h"
+
+//      (). needle    
+inline bool containsNoCase(const char* text, size_t length, const char* needle, size_t needleLength) {
+    if (needleLength == 0) {
+        return true;
+    }
+    if (needleLength > length) {
+        return false;
+    }
+    for (size_t i = 0; i + needleLength <= length; ++i) {
+        size_t j = 0;
+        while (j < needleLength) {
+            char c = text[i + j];
+            if (c >= 'A' && c <= 'Z') {
+                c = static_cast<char>(c - 'A' + 'a');
+            }
+            if (c != needle[j]) {
+                break;
+            }
+            ++j;
+        }
+        if (j == needleLength) {
+            return true;
+        }
+    }
+    return false;
+}
+
+//     .
+//      BlockLines   .  
+//  (  ,    ) 
+//   ,   .    
+//         -.
+//       (   
+//  );     ,   
+// .        
+class TrigramIndex {
+public:
+    static const size_t BlockLines = 1024;
+
+    // ,  : TrigramIndex::start   -,
+    // step         .  
+    // ( "eror"     )     ,
+    //       
+    class Search {
+    private:
+        friend class TrigramIndex;
+
+        std::string needle;
+        std::vector<std::pair<uint64_t, uint64_t>> ranges;  //  [from, to)    
+        size_t range;                   //  
+        uint64_t next;                  //        next
+        std::vector<uint64_t> found;    //     
+        size_t limit;
+        bool complete;                  //    limit
+
+    public:
+        Search() :
+            range(0),
+            next(0),
+            limit(0),
+            complete(true) {}
+
+        //    deadline;  true,   
+        bool step(const LogStore& store, std::chrono::steady_clock::time_point deadline) {
+            size_t checked = 0;
+            while (range < ranges.size()) {
+                uint64_t from = std::max(ranges[range].first, store.firstId());
+                next = std::min(next, store.endId());
+                while (next > from) {
+                    if ((++checked & 4095) == 0 && std::chrono::steady_clock::now() > deadline) {
+                        return false;
+                    }
+                    LogLine line = store.line(--next);
+                    if (containsNoCase(line.begin, line.size(), needle.data(), needle.size())) {
+                        if (found.size() >= limit) {
+                            complete = false;
+                            range = ranges.size();
+                            return true;
+                        }
+                        found.push_back(next);
+                    }
+                }
+                if (++range < ranges.size()) {
+                    next = ranges[range].second;
+                }
+            }
+            return true;
+        }
+
+        //     (  limit  )
+        bool isComplete() const {
+            return complete;
+        }
+
+        //       
+        void takeResults(std::vector<uint64_t>& out) {
+            out.swap(found);
+            found.clear();
+            std::reverse(out.begin(), out.end());
+        }
+    };
+
+private:
+    struct PostingList {
+        std::vector<uint32_t> blocks;
+    };
+
+    static const size_t TrigramCount = 1 << 24;
+
+    std::unordered_map<uint32_t, PostingList> postings;
+    std::vector<uint64_t> seen;             //     
+    std::vector<uint32_t> blockTrigrams;    //    
+    uint64_t currentBlock;
+    bool hasCurrent;
+    uint64_t firstBlock;                    //     
+    uint64_t prunedBlock;                   //       
+    uint64_t indexedEnd;                    //      
+
+public:
+    TrigramIndex() :
+        seen(TrigramCount / 64, 0),
+        currentBlock(0),
+        hasCurrent(false),
+        firstBlock(0),
+        prunedBlock(0),
+        indexedEnd(0) {}
+
+    //     
+    void add(uint64_t id, const char* text, size_t length) {
+        uint64_t block = id / BlockLines;
+        if (hasCurrent && block != currentBlock) {
+            sealBlock();
+        }
+        currentBlock = block;
+        hasCurrent = true;
+        indexedEnd = id + 1;
+
+        if (length < 3) {
+            return;
+        }
+        uint32_t trigram = (static_cast<uint32_t>(fold(text[0])) << 8) | fold(text[1]);
+        for (size_t i = 2; i < length; ++i) {
+            trigram = ((trigram << 8) | fold(text[i])) & (TrigramCount - 1);
+            uint64_t& word = seen[trigram >> 6];
+            uint64_t bit = static_cast<uint64_t>(1) << (trigram & 63);
+            if (!(word & bit)) {
+                word |= bit;
+                blockTrigrams.push_back(trigram);
+            }
+        }
+    }
+
+    //     firstId.  ,  
+    //      ,     
+    void prune(uint64_t firstId) {
+        firstBlock = firstId / BlockLines;
+        if (!hasCurrent || firstBlock <= prunedBlock) {
+            return;
+        }
+        uint64_t liveBlocks = currentBlock >= firstBlock ? currentBlock - firstBlock + 1 : 0;
+        if ((firstBlock - prunedBlock) * 2 < liveBlocks) {
+            return;
+        }
+
+        for (auto it = postings.begin(); it != postings.end();) {
+            std::vector<uint32_t>& blocks = it->second.blocks;
+            auto live = std::lower_bound(blocks.begin(), blocks.end(), static_cast<uint32_t>(firstBlock));
+            blocks.erase(blocks.begin(), live);
+            if (blocks.empty()) {
+                it = postings.erase(it);
+            }
+            else {
+                ++it;
+            }
+        }
+        prunedBlock = firstBlock;
+    }
+
+    //   ;      nextId
+    void clear(uint64_t nextId) {
+        postings.clear();
+        for (uint32_t trigram : blockTrigrams) {
+            seen[trigram >> 6] = 0;
+        }
+        blockTrigrams.clear();
+        hasCurrent = false;
+        firstBlock = 0;
+        prunedBlock = 0;
+        indexedEnd = nextId;
+    }
+
+    uint64_t getIndexedEnd() const { return indexedEnd; }
+
+    //   ,  query (   ).
+    //       ,  ,
+    //     ;      
+    void start(const LogStore& store, const std::string& query, size_t limit, Search& search) const {
+        search.needle = query;
+        for (char& c : search.needle) {
+            c = static_cast<char>(fold(c));
+        }
+        search.ranges.clear();
+        search.found.clear();
+        search.range = 0;
+        search.limit = limit;
+        search.complete = true;
+
+        if (search.needle.size() < 3) {
+            search.ranges.emplace_back(store.firstId(), store.endId());
+        }
+        else {
+            std::vector<uint64_t> candidates;
+            candidateBlocks(search.needle, candidates);
+            //       ,       -
+            //   
+            uint64_t tail = hasCurrent ? currentBlock * BlockLines : indexedEnd;
+            if (!candidates.empty() && candidates.back() * BlockLines >= tail) {
+                tail = (candidates.back() + 1) * BlockLines;
+            }
+            search.ranges.emplace_back(tail, store.endId());
+            for (auto it = candidates.rbegin(); it != candidates.rend(); ++it) {
+                search.ranges.emplace_back(*it * BlockLines, (*it + 1) * BlockLines);
+            }
+        }
+        search.next = search.ranges[0].second;
+    }
+
+    //  ,  query,       .
+    //    limit,  out  limit     false.
+    //      ,   ,  
+    //  limit  
+    bool find(const LogStore& store, const std::string& query, std::vector<uint64_t>& out, size_t limit) const {
+        Search search;
+        start(store, query, limit, search);
+        search.step(store, std::chrono::steady_clock::time_point::max());
+        search.takeResults(out);
+        return search.isComplete();
+    }
+
+    //     
+    size_t postingCount() const {
+        size_t total = 0;
+        for (const auto& entry : postings) {
+            total += entry.second.blocks.size();
+        }
+        return total;
+    }
+
+private:
+    static uint8_t fold(char c) {
+        return static_cast<uint8_t>(c >= 'A' && c <= 'Z' ? c - 'A' + 'a' : c);
+    }
+
+    //      
+    void sealBlock() {
+        for (uint32_t trigram : blockTrigrams) {
+            postings[trigram].blocks.push_back(static_cast<uint32_t>(currentBlock));
+            seen[trigram >> 6] = 0;
+        }
+        blockTrigrams.clear();
+    }
+
+    //       needle
+    void candidateBlocks(const std::string& needle, std::vector<uint64_t>& candidates) const {
+        std::vector<const std::vector<uint32_t>*> lists;
+        for (size_t i = 0; i + 3 <= needle.size(); ++i) {
+            uint32_t trigram = (static_cast<uint32_t>(static_cast<uint8_t>(needle[i])) << 16) |
+                (static_cast<uint32_t>(static_cast<uint8_t>(needle[i + 1])) << 8) |
+                static_cast<uint8_t>(needle[i + 2]);
+            auto it = postings.find(trigram);
+            if (it == postings.end()) {
+                return;
+            }
+            lists.push_back(&it->second.blocks);
+        }
+
+        //     ,    
+        std::sort(lists.begin(), lists.end(), [](const std::vector<uint32_t>* a, const std::vector<uint32_t>* b) {
+            return a->size() < b->size();
+        });
+        const std::vector<uint32_t>& shortest = *lists[0];
+        auto begin = std::lower_bound(shortest.begin(), shortest.end(), static_cast<uint32_t>(firstBlock));
+        for (auto it = begin; it != shortest.end(); ++it) {
+            bool everywhere = true;
+            for (size_t i = 1; i < lists.size() && everywhere; ++i) {
+                everywhere = std::binary_search(lists[i]->begin(), lists[i]->end(), *it);
+            }
+            if (everywhere) {
+                candidates.push_back(*it);
+            }
+        }
+    }
+};
\ No newline at end of file
@@ -0,0 +1,203 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+
+#include "imgui.h"
+#include "imgui_internal.h"
+
+//         .
+//         float 
+// ,   ImGui     . 
+//           ( 
+//    ),      
+//  MaxScrollHeight.      ,
+//     ,   ,   
+class VirtualScroll {
+public:
+    //   :     
+    struct Position {
+        size_t line;
+        size_t row;
+    };
+
+    static const size_t NoLine = SIZE_MAX;
+    static constexpr float MaxScrollHeight = 1.0e6f;   //    , 
+    static const int WheelRows = 3;                     //      
+
+private:
+    Position top;               //   
+    bool atEnd;                 //   
+    size_t jumpLine;            // ,      
+    float wheelRest;            //     ()
+    float lineHeight;
+    float baseY;                //      
+    float contentEnd;           //  ,  
+    size_t drawRows;            //      
+
+public:
+    VirtualScroll() :
+        top{ 0, 0 },
+        atEnd(true),
+        jumpLine(NoLine),
+        wheelRest(0.0f),
+        lineHeight(1.0f),
+        baseY(0.0f),
+        contentEnd(0.0f),
+        drawRows(0) {}
+
+    //        
+    void scrollTo(size_t line) {
+        jumpLine = line;
+    }
+
+    //     ,   (  )
+    void setTopLine(size_t line) {
+        top.line = line;
+    }
+
+    Position getTop() const {
+        return top;
+    }
+
+    bool isAtEnd() const {
+        return atEnd;
+    }
+
+    // ,      getTop()
+    size_t getDrawRows() const {
+        return drawRows;
+    }
+
+    //   ,    ,   
+    //    . rowsOf(line) -    (  1).
+    // follow -   ,    
+    template <typename RowsFunction>
+    void update(size_t lineCount, float rowHeight, bool follow, RowsFunction rowsOf) {
+        lineHeight = rowHeight;
+        float visibleHeight = ImGui::GetWindowContentRegionMax().y - ImGui::GetWindowContentRegionMin().y;
+        size_t visibleRows = std::max(static_cast<size_t>(visibleHeight / lineHeight), static_cast<size_t>(1));
+        if (top.line < lineCount) {
+            //     (  )
+            top.row = std::min(top.row, rowsOf(top.line) - 1);
+        }
+
+        //  ,     .    
+        //    ,    -  
+        Position last = move(Position{ lineCount, 0 }, -static_cast<int64_t>(visibleRows), lineCount, rowsOf);
+        double span = static_cast<double>(last.line) + last.row;
+        float scrollRange = static_cast<float>(std::min(span * lineHeight, static_cast<double>(MaxScrollHeight)));
+
+        ImGuiWindow* window = ImGui::GetCurrentWindow();
+        bool dragging = ImGui::GetActiveID() == ImGui::GetWindowScrollbarID(window, ImGuiAxis_Y);
+        if (dragging) {
+            //   : ImGui   ,   
+            float scrollMax = ImGui::GetScrollMaxY();
+            double fraction = scrollMax > 0.0f ? std::min(ImGui::GetScrollY() / scrollMax, 1.0f) : 0.0f;
+            top = positionAt(fraction * span, last, rowsOf);
+        }
+        else if (jumpLine != NoLine && jumpLine < lineCount) {
+            top = move(Position{ jumpLine, 0 }, -static_cast<int64_t>(visibleRows / 2), lineCount, rowsOf);
+        }
+        else if (follow && atEnd) {
+            top = last;
+        }
+        jumpLine = NoLine;
+
+        //  :    ImGuiWindowFlags_NoScrollWithMouse
+        if (ImGui::IsWindowHovered()) {
+            ImGuiIO& io = ImGui::GetIO();
+            float wheelX = io.KeyShift ? io.MouseWheel : io.MouseWheelH;
+            float wheelY = io.KeyShift ? 0.0f : io.MouseWheel;
+            if (wheelX != 0.0f) {
+                ImGui::SetScrollX(ImGui::GetScrollX() - wheelX * 2.0f * ImGui::GetFontSize());
+            }
+            if (wheelY != 0.0f && !dragging) {
+                float rows = wheelRest - wheelY * WheelRows;
+                int64_t whole = static_cast<int64_t>(rows);
+                wheelRest = rows - whole;
+                top = move(top, whole, lineCount, rowsOf);
+            }
+        }
+
+        if (!before(top, last)) {
+            top = last;
+        }
+        atEnd = !before(top, last);
+
+        float startY = ImGui::GetCursorPosY();
+        baseY = startY + ImGui::GetScrollY();
+        contentEnd = startY + scrollRange + visibleHeight;
+        drawRows = std::min(visibleRows + 1, static_cast<size_t>(std::max((contentEnd - baseY) / lineHeight, 0.0f)));
+        if (!dragging) {
+            ImGui::SetScrollY(span > 0.0 ? static_cast<float>(scrollIndex(top, last, rowsOf) / span * scrollRange) : 0.0f);
+        }
+    }
+
+    //        row ( getTop())
+    void placeRow(size_t row) const {
+        ImGui::SetCursorPosY(baseY + row * lineHeight);
+    }
+
+    //   ,    
+    void finish() const {
+        ImGui::SetCursorPosY(contentEnd);
+        ImGui::Dummy(ImVec2(0.0f, 0.0f));
+    }
+
+private:
+    static bool before(const Position& a, const Position& b) {
+        return a.line < b.line || (a.line == b.line && a.row < b.row);
+    }
+
+    //    rows   (  rows < 0)
+    template <typename RowsFunction>
+    static Position move(Position position, int64_t rows, size_t lineCount, RowsFunction& rowsOf) {
+        while (rows > 0 && position.line < lineCount) {
+            size_t left = rowsOf(position.line) - position.row;
+            if (static_cast<uint64_t>(rows) < left) {
+                position.row += static_cast<size_t>(rows);
+                return position;
+            }
+            rows -= static_cast<int64_t>(left);
+            ++position.line;
+            position.row = 0;
+        }
+        while (rows < 0) {
+            if (static_cast<uint64_t>(-rows) <= position.row) {
+                position.row -= static_cast<size_t>(-rows);
+                return position;
+            }
+            if (position.line == 0) {
+                position.row = 0;
+                return position;
+            }
+            rows += static_cast<int64_t>(position.row) + 1;
+            --position.line;
+            position.row = rowsOf(position.line) - 1;
+        }
+        return position;
+    }
+
+    //     :   last -  ,  last - 
+    template <typename RowsFunction>
+    static double scrollIndex(const Position& position, const Position& last, RowsFunction& rowsOf) {
+        if (position.line >= last.line) {
+            return static_cast<double>(last.line) + position.row;
+        }
+        return position.line + static_cast<double>(position.row) / rowsOf(position.line);
+    }
+
+    //   scrollIndex
+    template <typename RowsFunction>
+    static Position positionAt(double index, const Position& last, RowsFunction& rowsOf) {
+        if (index >= last.line) {
+            size_t row = static_cast<size_t>(index - last.line + 0.5);
+            return Position{ last.line, std::min(row, last.row) };
+        }
+        size_t line = static_cast<size_t>(index);
+        size_t row = static_cast<size_t>((index - line) * rowsOf(line));
+        return Position{ line, row };
+    }
+};
\ No newline at end of file
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "imgui.h"
+#include "LogStore.h"
+
+//         .
+//        ,    
+//     (  VirtualScroll),   
+//   ,    .  
+// MaxCachedLines      ,   
+//    :      
+//    
+class WrapLayout {
+private:
+    static const size_t MaxCachedLines = 65536;
+    static const size_t MaxCachedBreaks = 4 * 1024 * 1024;
+
+    struct Entry {
+        uint32_t breakStart;        //       breaks
+        uint32_t breakCount;
+    };
+
+    const ImFont* font;
+    float fontSize;
+    float width;
+    float maxAdvance;               //     (  )
+
+    std::unordered_map<uint64_t, Entry> entries;   //    
+    std::vector<uint32_t> breaks;   //   ,     2, 3, ...
+
+public:
+    WrapLayout() :
+        font(nullptr),
+        fontSize(0.0f),
+        width(0.0f),
+        maxAdvance(0.0f) {}
+
+    //  ,     
+    void sync(const ImFont* currentFont, float currentFontSize, float currentWidth) {
+        if (currentFont == font && currentFontSize == fontSize && currentWidth == width) {
+            return;
+        }
+        font = currentFont;
+        fontSize = currentFontSize;
+        width = currentWidth;
+
+        maxAdvance = font->FallbackAdvanceX;
+        for (int i = 0; i < font->IndexAdvanceX.Size; ++i) {
+            maxAdvance = std::max(maxAdvance, font->IndexAdvanceX[i]);
+        }
+        maxAdvance *= fontSize / font->FontSize;
+        clear();
+    }
+
+    //     (  ),    .
+    // firstRowIndent(line) - ,        .
+    // points    
+    template <typename IndentFunction>
+    size_t breaksOf(const LogStore& store, uint64_t id, IndentFunction firstRowIndent, const uint32_t*& points) {
+        auto it = entries.find(id);
+        if (it == entries.end()) {
+            if (entries.size() >= MaxCachedLines || breaks.size() >= MaxCachedBreaks) {
+                clear();
+            }
+            LogLine line = store.line(id);
+            Entry entry;
+            entry.breakStart = static_cast<uint32_t>(breaks.size());
+            entry.breakCount = static_cast<uint32_t>(computeBreaks(line, firstRowIndent(line)));
+            it = entries.emplace(id, entry).first;
+        }
+        points = breaks.data() + it->second.breakStart;
+        return it->second.breakCount;
+    }
+
+    void clear() {
+        entries.clear();
+        breaks.clear();
+    }
+
+private:
+    //    ,    
+    size_t computeBreaks(const LogLine& line, float indent) {
+        // ,   ,   
+        float firstWidth = std::max(width - indent, maxAdvance);
+        if (line.size() * maxAdvance <= firstWidth && !std::memchr(line.begin, '\n', line.size())) {
+            return 0;
+        }
+
+        float scale = fontSize / font->FontSize;
+        size_t added = 0;
+        const char* s = line.begin;
+        float rowWidth = firstWidth;
+        while (s < line.end) {
+            const char* wrap = font->CalcWordWrapPositionA(scale, s, line.end, rowWidth);
+            if (wrap == s) {
+                //   :    (,   UTF-8),   
+                wrap = s + 1;
+                while (wrap < line.end && (static_cast<unsigned char>(*wrap) & 0xC0) == 0x80) {
+                    ++wrap;
+                }
+            }
+
+            //   ImGui  ,         
+            s = wrap;
+            while (s < line.end && (*s == ' ' || *s == '\t')) {
+                ++s;
+            }
+            if (s < line.end && *s == '\n') {
+                ++s;
+            }
+            if (s >= line.end) {
+                break;
+            }
+            breaks.push_back(static_cast<uint32_t>(s - line.begin));
+            ++added;
+            rowWidth = std::max(width, maxAdvance);
+        }
+        return added;
+    }
+};
\ No newline at end of file